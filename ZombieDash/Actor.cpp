@@ -1,10 +1,12 @@
 #include "Actor.h"
 #include "StudentWorld.h"
+#include "Profiler.h"
 
 Actor::Actor(StudentWorld * w, int imageID, double x, double y, int dir, int depth)
-	: GraphObject(imageID, x, y, dir, depth) {
+	: GraphObject(w->scene(), imageID, x, y, dir, depth) {
 	m_world = w;
 	m_dead = false;
+	m_id = 0;
 }
 
 bool Actor::isDead() const {
@@ -19,6 +21,19 @@ StudentWorld * Actor::world() const {
 	return m_world;
 }
 
+unsigned int Actor::id() const {
+	return m_id;
+}
+
+void Actor::setID(unsigned int id) {
+	m_id = id;
+}
+
+// most actors have nothing to save beyond position and direction
+void Actor::saveState(int /* values */[]) const {}
+
+void Actor::restoreState(const int /* values */[]) {}
+
 void Actor::activateIfAppropriate(Actor * a) {}
 
 void Actor::useExitIfAppropriate() {}
@@ -58,6 +73,10 @@ Wall::Wall(StudentWorld * w, double x, double y)
 
 void Wall::doSomething() {}
 
+ActorKind Wall::kind() const {
+	return KIND_WALL;
+}
+
 bool Wall::blocksMovement() const {
 	return true;
 }
@@ -77,6 +96,7 @@ Exit::Exit(StudentWorld* w, double x, double y)
 	: ActivatingObject(w, IID_EXIT, x, y, right, 1) {}
 
 void Exit::doSomething() {
+	PROFILE_ACTOR_SCOPE("Exit::doSomething", this);
 	// The exit must determine if it overlaps with a citizen (not Penelope!)
 
 	// if all citizens gone and overlaps with Penelope
@@ -85,6 +105,10 @@ void Exit::doSomething() {
 	}
 }
 
+ActorKind Exit::kind() const {
+	return KIND_EXIT;
+}
+
 void Exit::activateIfAppropriate(Actor * a) {
 	a->useExitIfAppropriate();
 }
@@ -99,6 +123,7 @@ Pit::Pit(StudentWorld* w, double x, double y)
 	: ActivatingObject(w, IID_PIT, x, y, right, 0) {}
 
 void Pit::doSomething() {
+	PROFILE_ACTOR_SCOPE("Pit::doSomething", this);
 	world()->activateOnAppropriateActors(this);
 }
 
@@ -106,6 +131,10 @@ void Pit::activateIfAppropriate(Actor * a) {
 	a->dieByFallOrBurnIfAppropriate();
 }
 
+ActorKind Pit::kind() const {
+	return KIND_PIT;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 Flame::Flame(StudentWorld* w, double x, double y, int dir)
@@ -114,6 +143,7 @@ Flame::Flame(StudentWorld* w, double x, double y, int dir)
 }
 
 void Flame::doSomething() {
+	PROFILE_ACTOR_SCOPE("Flame::doSomething", this);
 	if (isDead()) {
 		return;
 	}
@@ -133,6 +163,18 @@ void Flame::activateIfAppropriate(Actor* a) {
 	a->dieByFallOrBurnIfAppropriate();
 }
 
+ActorKind Flame::kind() const {
+	return KIND_FLAME;
+}
+
+void Flame::saveState(int values[]) const {
+	values[0] = m_tick;
+}
+
+void Flame::restoreState(const int values[]) {
+	m_tick = values[0];
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 Vomit::Vomit(StudentWorld* w, double x, double y, int dir)
@@ -141,6 +183,7 @@ Vomit::Vomit(StudentWorld* w, double x, double y, int dir)
 }
 
 void Vomit::doSomething() {
+	PROFILE_ACTOR_SCOPE("Vomit::doSomething", this);
 	if (isDead()) {
 		return;
 	}
@@ -161,6 +204,18 @@ void Vomit::activateIfAppropriate(Actor * a) {
 	a->beVomitedOnIfAppropriate();
 }
 
+ActorKind Vomit::kind() const {
+	return KIND_VOMIT;
+}
+
+void Vomit::saveState(int values[]) const {
+	values[0] = m_tick;
+}
+
+void Vomit::restoreState(const int values[]) {
+	m_tick = values[0];
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 Landmine::Landmine(StudentWorld* w, double x, double y)
@@ -170,6 +225,7 @@ Landmine::Landmine(StudentWorld* w, double x, double y)
 }
 
 void Landmine::doSomething() {
+	PROFILE_ACTOR_SCOPE("Landmine::doSomething", this);
 	if (isDead()) {
 		return;
 	}
@@ -253,6 +309,20 @@ void Landmine::dieByFallOrBurnIfAppropriate() {
 	}
 }
 
+ActorKind Landmine::kind() const {
+	return KIND_LANDMINE;
+}
+
+void Landmine::saveState(int values[]) const {
+	values[0] = m_tick;
+	values[1] = m_active;
+}
+
+void Landmine::restoreState(const int values[]) {
+	m_tick = values[0];
+	m_active = (values[1] != 0);
+}
+
 Agent::Agent(StudentWorld * w, int imageID, double x, double y, int dir)
 	: Actor(w, imageID, x, y, dir, 0) {}
 
@@ -297,6 +367,16 @@ bool Human::isInfected() const {
 	return m_infected;
 }
 
+void Human::saveState(int values[]) const {
+	values[0] = m_infectionCount;
+	values[1] = m_infected;
+}
+
+void Human::restoreState(const int values[]) {
+	m_infectionCount = values[0];
+	m_infected = (values[1] != 0);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 Penelope::Penelope(StudentWorld * w, double x, double y)
@@ -307,6 +387,7 @@ Penelope::Penelope(StudentWorld * w, double x, double y)
 }
 
 void Penelope::doSomething() {
+	PROFILE_ACTOR_SCOPE("Penelope::doSomething", this);
 	if (isDead()) {							// if she's dead, don't do anything
 		return;
 	}
@@ -484,6 +565,24 @@ void Penelope::decreaseLandmines() {
 	m_nLandmines--;
 }
 
+ActorKind Penelope::kind() const {
+	return KIND_PENELOPE;
+}
+
+void Penelope::saveState(int values[]) const {
+	Human::saveState(values);
+	values[2] = m_nVaccines;
+	values[3] = m_nFlameCharges;
+	values[4] = m_nLandmines;
+}
+
+void Penelope::restoreState(const int values[]) {
+	Human::restoreState(values);
+	m_nVaccines = values[2];
+	m_nFlameCharges = values[3];
+	m_nLandmines = values[4];
+}
+
 int Penelope::getNumVaccines() const {
 	return m_nVaccines;
 }
@@ -502,6 +601,7 @@ Citizen::Citizen(StudentWorld* w, double x, double y)
 	: Human(w, IID_CITIZEN, x, y) {}
 
 void Citizen::doSomething() {
+	PROFILE_ACTOR_SCOPE("Citizen::doSomething", this);
 	if (isDead()) {
 		return;
 	}
@@ -531,6 +631,10 @@ void Citizen::doSomething() {
 	}
 }
 
+ActorKind Citizen::kind() const {
+	return KIND_CITIZEN;
+}
+
 void Citizen::useExitIfAppropriate() {
 	setDead();
 }
@@ -582,7 +686,18 @@ bool Zombie::isParalyzed() const {
 	return m_tick % 2 == 0;
 }
 
+void Zombie::saveState(int values[]) const {
+	values[0] = m_movementPlanDistance;
+	values[1] = m_tick;
+}
+
+void Zombie::restoreState(const int values[]) {
+	m_movementPlanDistance = values[0];
+	m_tick = values[1];
+}
+
 void Zombie::doSomething() {
+	PROFILE_ACTOR_SCOPE("Zombie::doSomething", this);
 	if (isDead()) {
 		return;
 	}
@@ -700,6 +815,10 @@ void DumbZombie::doSomeThing() {
 	
 
 
+}
+
+ActorKind DumbZombie::kind() const {
+	return KIND_DUMB_ZOMBIE;
 }
 
 void DumbZombie::dieByFallOrBurnIfAppropriate() {
@@ -721,6 +840,10 @@ SmartZombie::SmartZombie(StudentWorld* w, double x, double y)
 
 void SmartZombie::doSomeThing() {}
 
+ActorKind SmartZombie::kind() const {
+	return KIND_SMART_ZOMBIE;
+}
+
 void SmartZombie::dieByFallOrBurnIfAppropriate() {
 	setDead();
 	world()->playSound(SOUND_ZOMBIE_DIE);
@@ -748,6 +871,7 @@ VaccineGoodie::VaccineGoodie(StudentWorld * w, double x, double y)
 	: Goodie(w, IID_VACCINE_GOODIE, x, y) {}
 
 void VaccineGoodie::doSomething() {
+	PROFILE_ACTOR_SCOPE("VaccineGoodie::doSomething", this);
 	if (isDead()) {
 		return;
 	}
@@ -760,12 +884,17 @@ void VaccineGoodie::increaseGoodieCount() {
 	world()->player()->increaseVaccines();
 }
 
+ActorKind VaccineGoodie::kind() const {
+	return KIND_VACCINE_GOODIE;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 GasCanGoodie::GasCanGoodie(StudentWorld * w, double x, double y)
 	: Goodie(w, IID_GAS_CAN_GOODIE, x, y) {}
 
 void GasCanGoodie::doSomething() {
+	PROFILE_ACTOR_SCOPE("GasCanGoodie::doSomething", this);
 	if (isDead()) {
 		return;
 	}
@@ -778,12 +907,17 @@ void GasCanGoodie::increaseGoodieCount() {
 	world()->player()->increaseFlameCharges();
 }
 
+ActorKind GasCanGoodie::kind() const {
+	return KIND_GAS_CAN_GOODIE;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 LandmineGoodie::LandmineGoodie(StudentWorld * w, double x, double y)
 	: Goodie(w, IID_LANDMINE_GOODIE, x, y) {}
 
 void LandmineGoodie::doSomething() {
+	PROFILE_ACTOR_SCOPE("LandmineGoodie::doSomething", this);
 	if (isDead()) {
 		return;
 	}
@@ -794,4 +928,8 @@ void LandmineGoodie::doSomething() {
 
 void LandmineGoodie::increaseGoodieCount() {
 	world()->player()->increaseLandmines();
+}
+
+ActorKind LandmineGoodie::kind() const {
+	return KIND_LANDMINE_GOODIE;
 }
\ No newline at end of file
@@ -6,6 +6,13 @@
 class StudentWorld;
 class Goodie;
 
+// The kinds of actor, as a saved world state records them
+enum ActorKind {
+	KIND_WALL, KIND_EXIT, KIND_PIT, KIND_FLAME, KIND_VOMIT, KIND_LANDMINE,
+	KIND_VACCINE_GOODIE, KIND_GAS_CAN_GOODIE, KIND_LANDMINE_GOODIE,
+	KIND_PENELOPE, KIND_CITIZEN, KIND_DUMB_ZOMBIE, KIND_SMART_ZOMBIE
+};
+
 class Actor : public GraphObject {
 public:
     Actor(StudentWorld* w, int imageID, double x, double y, int dir, int depth);
@@ -21,6 +28,19 @@ public:
 	
 	// Get this actor's world
 	StudentWorld* world() const;
+
+	// What kind of actor is this?
+	virtual ActorKind kind() const = 0;
+
+	// This actor's ID, which no other actor in the level has (0 for
+	// Penelope; the world numbers the rest as they're added).
+	unsigned int id() const;
+	void setID(unsigned int id);
+
+	// Save the state this actor has beyond its position and direction into
+	// values (RewindObject::NUM_VALUES of them), or restore it from them.
+	virtual void saveState(int values[]) const;
+	virtual void restoreState(const int values[]);
 	
 	// If this is an activated object, perform its effect on a (e.g., for an
 	// Exit have a use the exit).
@@ -56,6 +76,7 @@ public:
 private:
 	StudentWorld* m_world;
 	bool m_dead;
+	unsigned int m_id;
 };
 
 class Wall : public Actor {
@@ -63,6 +84,7 @@ public:
 	Wall(StudentWorld* w, double x, double y);
 	
 	virtual void doSomething();
+	virtual ActorKind kind() const;
 	virtual bool blocksMovement() const;
 	virtual bool blocksFlame() const;
 };
@@ -77,6 +99,7 @@ public:
     Exit(StudentWorld* w, double x, double y);
 
 	virtual void doSomething();
+	virtual ActorKind kind() const;
 	virtual void activateIfAppropriate(Actor* a);
 	virtual bool blocksFlame() const;
 };
@@ -86,6 +109,7 @@ public:
 	Pit(StudentWorld* w, double x, double y);
 	
 	virtual void doSomething();
+	virtual ActorKind kind() const;
 	virtual void activateIfAppropriate(Actor* a);
 };
 
@@ -95,6 +119,9 @@ public:
 
     virtual void doSomething();
     virtual void activateIfAppropriate(Actor* a);
+	virtual ActorKind kind() const;
+	virtual void saveState(int values[]) const;
+	virtual void restoreState(const int values[]);
 
 private:
 	int m_tick;
@@ -106,6 +133,9 @@ public:
 
 	virtual void doSomething();
 	virtual void activateIfAppropriate(Actor* a);
+	virtual ActorKind kind() const;
+	virtual void saveState(int values[]) const;
+	virtual void restoreState(const int values[]);
 
 private:
 	int m_tick;
@@ -118,6 +148,9 @@ public:
 	virtual void doSomething();
 	virtual void activateIfAppropriate(Actor* a);
 	virtual void dieByFallOrBurnIfAppropriate();
+	virtual ActorKind kind() const;
+	virtual void saveState(int values[]) const;
+	virtual void restoreState(const int values[]);
 
 private:
 	int m_tick;
@@ -141,6 +174,7 @@ public:
 	
 	virtual void doSomething();
 	virtual void increaseGoodieCount();
+	virtual ActorKind kind() const;
 };
 
 class GasCanGoodie : public Goodie {
@@ -148,6 +182,7 @@ public:
     GasCanGoodie(StudentWorld* w, double x, double y);
     virtual void doSomething();
 	virtual void increaseGoodieCount();
+	virtual ActorKind kind() const;
 };
 
 class LandmineGoodie : public Goodie {
@@ -156,6 +191,7 @@ public:
 
     virtual void doSomething();
 	virtual void increaseGoodieCount();
+	virtual ActorKind kind() const;
 };
 
 class Agent : public Actor {
@@ -178,6 +214,9 @@ public:
 	
 	int getInfectionDuration() const;	// gets infection count
 	bool isInfected() const;			// Is human infected?
+
+	virtual void saveState(int values[]) const;		// infection count and whether infected
+	virtual void restoreState(const int values[]);
 	
 private:
 	int m_infectionCount;
@@ -191,6 +230,9 @@ public:
 	virtual void doSomething();
 	virtual void useExitIfAppropriate();
 	virtual void dieByFallOrBurnIfAppropriate();
+	virtual ActorKind kind() const;
+	virtual void saveState(int values[]) const;		// what a human saves, then goodie counts
+	virtual void restoreState(const int values[]);
 	
 	void increaseVaccines();		// Increase the number of vaccines the object has.
 	void decreaseVaccines();		// Decrease the number of vaccines after usage.
@@ -223,6 +265,7 @@ public:
     virtual void doSomething();
     virtual void useExitIfAppropriate();
     virtual void dieByFallOrBurnIfAppropriate();
+	virtual ActorKind kind() const;
 };
 
 class Zombie : public Agent {
@@ -243,6 +286,9 @@ public:
 
 	virtual void doSomething();				// pure virtual to create dumb/smart zombies
 
+	virtual void saveState(int values[]) const;		// movement plan distance and tick
+	virtual void restoreState(const int values[]);
+
 private:
 	int m_movementPlanDistance;
 	int m_tick;
@@ -254,6 +300,7 @@ public:
 	
 	virtual void doSomeThing();
 	virtual void dieByFallOrBurnIfAppropriate();
+	virtual ActorKind kind() const;
 };
 
 class SmartZombie : public Zombie {
@@ -262,6 +309,7 @@ public:
 
     virtual void doSomeThing();
     virtual void dieByFallOrBurnIfAppropriate();
+	virtual ActorKind kind() const;
 };
 
 #endif // ACTOR_INCLUDED
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef ALLOCATIONCOUNTER_H_
+#define ALLOCATIONCOUNTER_H_
+
+#include <atomic>
+
+  // Counts calls to the global operator new.  The counting operators are
+  // defined in AllocationCounter.cpp; a program that doesn't link that file
+  // in always sees a count of zero.
+
+class AllocationCounter
+{
+  public:
+    static long long allocations()
+    {
+        return count().load(std::memory_order_relaxed);
+    }
+
+    static void recordAllocation()
+    {
+        count().fetch_add(1, std::memory_order_relaxed);
+    }
+
+  private:
+      // std::atomic has a constexpr constructor, so this is initialized
+      // before any allocation can happen and needs no guard.
+    static std::atomic<long long>& count()
+    {
+        static std::atomic<long long> allocationCount(0);
+        return allocationCount;
+    }
+};
+
+#endif // ALLOCATIONCOUNTER_H_
@@ -0,0 +1,604 @@
+#ifndef ASSETPACK_H_
+#define ASSETPACK_H_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+  // The game's assets can ship as one pack file instead of a directory of
+  // loose files.  A pack is an index followed by each file's contents:
+  //
+  //   header   "ZDPK", version, entry count, size of the name table (4 bytes each)
+  //   entries  name offset, name length, method (4 bytes each),
+  //            data offset, stored size, original size (8 bytes each)
+  //   names    the entries' file names, sorted, without separators
+  //   data     each entry's bytes, starting on a DATA_ALIGNMENT boundary
+  //
+  // Numbers are little-endian.  An entry is either stored as is, so readers
+  // get a view straight into the mapped pack, or compressed with a small
+  // LZ77 coder (see AssetCompression) when that saves space.
+
+  // The bytes of one asset.  For a stored entry of a mapped pack this is a
+  // view of the mapping, which lives as long as the program; otherwise
+  // (compressed entries, loose files) the bytes are in a buffer of its own.
+class AssetData
+{
+  public:
+    AssetData()
+     : m_data(nullptr), m_size(0)
+    {}
+
+    AssetData(AssetData&& other)
+     : m_data(other.m_data), m_size(other.m_size), m_buffer(std::move(other.m_buffer))
+    {}
+
+    AssetData& operator=(AssetData&& other)
+    {
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_buffer = std::move(other.m_buffer);
+        return *this;
+    }
+
+    const char* data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+      // Whether the bytes are the AssetData's own rather than a view
+    bool ownsData() const
+    {
+        return !m_buffer.empty();
+    }
+
+    void setView(const char* data, size_t size)
+    {
+        m_buffer.clear();
+        m_data = data;
+        m_size = size;
+    }
+
+      // Make room for size bytes of the asset's own and return where they go
+    char* allocate(size_t size)
+    {
+        m_buffer.resize(size);
+        m_data = m_buffer.data();
+        m_size = size;
+        return m_buffer.data();
+    }
+
+    AssetData(const AssetData&) = delete;
+    AssetData& operator=(const AssetData&) = delete;
+
+  private:
+    const char*       m_data;
+    size_t            m_size;
+    std::vector<char> m_buffer;
+};
+
+  // An LZ77 coder in the spirit of LZ4: fast to decode and simple enough to
+  // check by eye.  The compressed form is a series of sequences, each a
+  // token byte (literal count in the high 4 bits, match length - 4 in the
+  // low 4), extra literal count bytes if the count is 15 or more, the
+  // literals, then a 2-byte offset back to the match and extra match length
+  // bytes if needed.  The final sequence has literals only.
+class AssetCompression
+{
+  public:
+    static std::vector<char> compress(const char* source, size_t size)
+    {
+        std::vector<char> out;
+        std::vector<int> table;
+        compress(source, size, out, table);
+        return out;
+    }
+
+      // The same, replacing out's contents and using table as scratch;
+      // once both have grown to fit, compressing allocates nothing
+    static void compress(const char* source, size_t size, std::vector<char>& out, std::vector<int>& table)
+    {
+        out.clear();
+        table.assign(HASH_SIZE, -1);    // last position with each hash
+        size_t literalStart = 0;
+        size_t pos = 0;
+        while (pos + MIN_MATCH <= size)
+        {
+            std::uint32_t h = hash(source + pos);
+            int candidate = table[h];
+            table[h] = static_cast<int>(pos);
+            if (candidate < 0  ||  pos - candidate > MAX_OFFSET  ||
+                std::memcmp(source + candidate, source + pos, MIN_MATCH) != 0)
+            {
+                pos++;
+                continue;
+            }
+
+            size_t matchLength = MIN_MATCH;
+            while (pos + matchLength < size  &&  source[candidate + matchLength] == source[pos + matchLength])
+                matchLength++;
+            writeSequence(out, source + literalStart, pos - literalStart, pos - candidate, matchLength);
+            pos += matchLength;
+            literalStart = pos;
+        }
+        writeSequence(out, source + literalStart, size - literalStart, 0, 0);
+    }
+
+      // Decode into exactly size bytes at dest; false if the input is damaged
+    static bool decompress(const char* source, size_t sourceSize, char* dest, size_t size)
+    {
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(source);
+        const unsigned char* inEnd = in + sourceSize;
+        size_t out = 0;
+        while (in < inEnd)
+        {
+            unsigned int token = *in++;
+            size_t literals = token >> 4;
+            if (literals == 15  &&  !readLength(in, inEnd, literals))
+                return false;
+            if (literals > static_cast<size_t>(inEnd - in)  ||  literals > size - out)
+                return false;
+            std::memcpy(dest + out, in, literals);
+            in += literals;
+            out += literals;
+            if (in == inEnd)    // the final sequence
+                break;
+
+            if (inEnd - in < 2)
+                return false;
+            size_t offset = in[0] | (in[1] << 8);
+            in += 2;
+            size_t matchLength = token & 15;
+            if (matchLength == 15  &&  !readLength(in, inEnd, matchLength))
+                return false;
+            matchLength += MIN_MATCH;
+            if (offset == 0  ||  offset > out  ||  matchLength > size - out)
+                return false;
+            for (size_t k = 0; k < matchLength; k++, out++)     // may overlap itself
+                dest[out] = dest[out - offset];
+        }
+        return out == size;
+    }
+
+      // The most that sourceSize compressed bytes can decode to (each extra
+      // length byte adds at most 255), for checking sizes read from a file
+      // before making room for them
+    static std::uint64_t maxDecompressedSize(std::uint64_t sourceSize)
+    {
+        return sourceSize * 255 + 16;
+    }
+
+  private:
+    static const size_t MIN_MATCH = 4;
+    static const size_t MAX_OFFSET = 65535;
+    static const int HASH_BITS = 14;
+    static const int HASH_SIZE = 1 << HASH_BITS;
+
+    static std::uint32_t hash(const char* p)
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return (v * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    static void writeLength(std::vector<char>& out, size_t n)
+    {
+        for ( ; n >= 255; n -= 255)
+            out.push_back(static_cast<char>(255));
+        out.push_back(static_cast<char>(n));
+    }
+
+    static bool readLength(const unsigned char*& in, const unsigned char* inEnd, size_t& n)
+    {
+        unsigned int b;
+        do
+        {
+            if (in == inEnd)
+                return false;
+            b = *in++;
+            n += b;
+        } while (b == 255);
+        return true;
+    }
+
+      // matchLength 0 means no match (the final sequence)
+    static void writeSequence(std::vector<char>& out, const char* literals, size_t nLiterals,
+                              size_t offset, size_t matchLength)
+    {
+        size_t matchCode = (matchLength == 0 ? 0 : matchLength - MIN_MATCH);
+        out.push_back(static_cast<char>((std::min<size_t>(nLiterals, 15) << 4) | std::min<size_t>(matchCode, 15)));
+        if (nLiterals >= 15)
+            writeLength(out, nLiterals - 15);
+        out.insert(out.end(), literals, literals + nLiterals);
+        if (matchLength == 0)
+            return;
+        out.push_back(static_cast<char>(offset & 0xff));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (matchCode >= 15)
+            writeLength(out, matchCode - 15);
+    }
+};
+
+class AssetPack
+{
+  public:
+    enum Method {
+        method_stored, method_compressed
+    };
+
+      // A file to go into a pack
+    struct Input
+    {
+        std::string       name;
+        std::vector<char> contents;
+    };
+
+    AssetPack()
+     : m_base(nullptr), m_size(0)
+#ifdef _WIN32
+       , m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#endif
+    {}
+
+    ~AssetPack()
+    {
+        close();
+    }
+
+      // Map the pack into memory and check its index.  This is the only time
+      // the file is opened.
+    bool open(std::string filename)
+    {
+        close();
+        if (!mapFile(filename)  ||  !readIndex())
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const
+    {
+        return m_base != nullptr;
+    }
+
+    bool contains(const std::string& name) const
+    {
+        return findEntry(name) != nullptr;
+    }
+
+      // A stored entry becomes a view of the mapping; a compressed one is
+      // decompressed into the AssetData's own buffer.
+    bool read(const std::string& name, AssetData& data) const
+    {
+        const Entry* e = findEntry(name);
+        if (e == nullptr)
+            return false;
+
+        const char* stored = m_base + e->dataOffset;
+        if (e->method == method_stored)
+        {
+            data.setView(stored, static_cast<size_t>(e->size));
+            return true;
+        }
+        char* dest = data.allocate(static_cast<size_t>(e->size));
+        return AssetCompression::decompress(stored, static_cast<size_t>(e->storedSize), dest, static_cast<size_t>(e->size));
+    }
+
+    std::vector<std::string> names() const
+    {
+        std::vector<std::string> result;
+        for (const Entry& e : m_entries)
+            result.push_back(e.name);
+        return result;
+    }
+
+      // Write a pack holding the given files.  With compress, each file is
+      // compressed if that makes it smaller.
+    static bool write(std::string filename, std::vector<Input> inputs, bool compress)
+    {
+        std::sort(inputs.begin(), inputs.end(),
+                  [](const Input& a, const Input& b) { return a.name < b.name; });
+
+        std::string names;
+        for (const Input& in : inputs)
+            names += in.name;
+
+        std::vector<char> index;
+        std::vector<char> data;
+        size_t dataStart = alignUp(HEADER_SIZE + inputs.size() * ENTRY_SIZE + names.size());
+        size_t nameOffset = 0;
+        for (const Input& in : inputs)
+        {
+            std::vector<char> packed;
+            std::uint32_t method = method_stored;
+            if (compress  &&  !in.contents.empty())
+            {
+                packed = AssetCompression::compress(in.contents.data(), in.contents.size());
+                if (packed.size() < in.contents.size())
+                    method = method_compressed;
+            }
+            const std::vector<char>& stored = (method == method_compressed ? packed : in.contents);
+
+            data.resize(alignUp(data.size()), 0);
+            putNumber(index, nameOffset, 4);
+            putNumber(index, in.name.size(), 4);
+            putNumber(index, method, 4);
+            putNumber(index, dataStart + data.size(), 8);
+            putNumber(index, stored.size(), 8);
+            putNumber(index, in.contents.size(), 8);
+            data.insert(data.end(), stored.begin(), stored.end());
+            nameOffset += in.name.size();
+        }
+
+        std::vector<char> file(magic(), magic() + 4);
+        putNumber(file, VERSION, 4);
+        putNumber(file, inputs.size(), 4);
+        putNumber(file, names.size(), 4);
+        file.insert(file.end(), index.begin(), index.end());
+        file.insert(file.end(), names.begin(), names.end());
+        file.resize(dataStart, 0);
+        file.insert(file.end(), data.begin(), data.end());
+
+        std::ofstream out(filename, std::ios::out|std::ios::binary);
+        out.write(file.data(), file.size());
+        return static_cast<bool>(out);
+    }
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+  private:
+    struct Entry
+    {
+        std::string   name;
+        std::uint32_t method;
+        std::uint64_t dataOffset;
+        std::uint64_t storedSize;
+        std::uint64_t size;
+    };
+
+    static const std::uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+    static const size_t ENTRY_SIZE = 36;
+    static const size_t DATA_ALIGNMENT = 16;
+
+    const char*        m_base;      // the mapped file, or nullptr
+    size_t             m_size;
+    std::vector<Entry> m_entries;   // sorted by name
+#ifdef _WIN32
+    HANDLE             m_file;
+    HANDLE             m_mapping;
+#endif
+
+    static const char* magic()
+    {
+        return "ZDPK";
+    }
+
+    static size_t alignUp(size_t n)
+    {
+        return (n + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+    }
+
+    static void putNumber(std::vector<char>& out, std::uint64_t n, int bytes)
+    {
+        for (int k = 0; k < bytes; k++)
+            out.push_back(static_cast<char>((n >> (8 * k)) & 0xff));
+    }
+
+    std::uint64_t getNumber(size_t offset, int bytes) const
+    {
+        std::uint64_t n = 0;
+        for (int k = bytes - 1; k >= 0; k--)
+            n = (n << 8) | static_cast<unsigned char>(m_base[offset + k]);
+        return n;
+    }
+
+    bool readIndex()
+    {
+        if (m_size < HEADER_SIZE  ||  std::memcmp(m_base, magic(), 4) != 0  ||  getNumber(4, 4) != VERSION)
+            return false;
+        std::uint64_t count = getNumber(8, 4);
+        std::uint64_t namesSize = getNumber(12, 4);
+        std::uint64_t namesStart = HEADER_SIZE + count * ENTRY_SIZE;
+        if (namesStart + namesSize > m_size)
+            return false;
+
+        m_entries.resize(static_cast<size_t>(count));
+        for (size_t k = 0; k < m_entries.size(); k++)
+        {
+            size_t p = HEADER_SIZE + k * ENTRY_SIZE;
+            std::uint64_t nameOffset = getNumber(p, 4);
+            std::uint64_t nameLength = getNumber(p + 4, 4);
+            Entry& e = m_entries[k];
+            e.method = static_cast<std::uint32_t>(getNumber(p + 8, 4));
+            e.dataOffset = getNumber(p + 12, 8);
+            e.storedSize = getNumber(p + 20, 8);
+            e.size = getNumber(p + 28, 8);
+            if (nameOffset + nameLength > namesSize  ||  e.dataOffset > m_size  ||
+                e.storedSize > m_size - e.dataOffset  ||
+                (e.method == method_stored  &&  e.storedSize != e.size)  ||  e.method > method_compressed  ||
+                e.size > AssetCompression::maxDecompressedSize(e.storedSize))
+                return false;
+            e.name.assign(m_base + namesStart + nameOffset, static_cast<size_t>(nameLength));
+        }
+        return std::is_sorted(m_entries.begin(), m_entries.end(),
+                              [](const Entry& a, const Entry& b) { return a.name < b.name; });
+    }
+
+    const Entry* findEntry(const std::string& name) const
+    {
+        auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name,
+                                   [](const Entry& e, const std::string& n) { return e.name < n; });
+        return (it != m_entries.end()  &&  it->name == name ? &*it : nullptr);
+    }
+
+#ifdef _WIN32
+    bool mapFile(const std::string& filename)
+    {
+        m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size)  ||  size.QuadPart == 0)
+            return false;
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping == nullptr)
+            return false;
+        m_base = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        m_size = static_cast<size_t>(size.QuadPart);
+        return m_base != nullptr;
+    }
+
+    void close()
+    {
+        if (m_base != nullptr)
+            UnmapViewOfFile(m_base);
+        if (m_mapping != nullptr)
+            CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(m_file);
+        m_base = nullptr;
+        m_size = 0;
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+        m_entries.clear();
+    }
+#else
+    bool mapFile(const std::string& filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat statbuf;
+        if (fstat(fd, &statbuf) != 0  ||  statbuf.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, static_cast<size_t>(statbuf.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);    // the mapping stays valid
+        if (p == MAP_FAILED)
+            return false;
+        m_base = static_cast<const char*>(p);
+        m_size = static_cast<size_t>(statbuf.st_size);
+        return true;
+    }
+
+    void close()
+    {
+        if (m_base != nullptr)
+            munmap(const_cast<char*>(m_base), m_size);
+        m_base = nullptr;
+        m_size = 0;
+        m_entries.clear();
+    }
+#endif
+};
+
+  // Where the game reads its assets from.  Once a pack is mounted, reading
+  // a path under the pack's directory looks the file up in the pack;
+  // anything else (or anything the pack lacks) is read from disk as a loose
+  // file.  Reading is safe from any thread once mounting is done.
+class AssetFileSystem
+{
+  public:
+      // Mount the pack at packFile in place of the directory dirPrefix
+      // (e.g. "Assets/"), whether or not that directory exists
+    bool mount(std::string packFile, std::string dirPrefix)
+    {
+        m_prefix = dirPrefix;
+        return m_pack.open(packFile);
+    }
+
+    bool isMounted() const
+    {
+        return m_pack.isOpen();
+    }
+
+      // Whether path comes from the pack (and so may not exist on disk)
+    bool isPacked(const std::string& path) const
+    {
+        std::string name;
+        return packName(path, name)  &&  m_pack.contains(name);
+    }
+
+    bool exists(const std::string& path) const
+    {
+        if (isPacked(path))
+            return true;
+        std::ifstream file(path, std::ios::in|std::ios::binary);
+        return static_cast<bool>(file);
+    }
+
+    bool read(const std::string& path, AssetData& data) const
+    {
+        std::string name;
+        if (packName(path, name)  &&  m_pack.read(name, data))
+            return true;
+
+        std::ifstream file(path, std::ios::in|std::ios::binary|std::ios::ate);
+        if (!file)
+            return false;
+        std::streamoff size = file.tellg();
+        file.seekg(0);
+        char* dest = data.allocate(static_cast<size_t>(size));
+        return static_cast<bool>(file.read(dest, size));
+    }
+
+      // Meyers singleton pattern
+    static AssetFileSystem& getInstance()
+    {
+        static AssetFileSystem instance;
+        return instance;
+    }
+
+  private:
+    AssetPack   m_pack;
+    std::string m_prefix;
+
+    AssetFileSystem() {}
+    AssetFileSystem(const AssetFileSystem&) = delete;
+    AssetFileSystem& operator=(const AssetFileSystem&) = delete;
+
+    bool packName(const std::string& path, std::string& name) const
+    {
+        if (!m_pack.isOpen()  ||  path.compare(0, m_prefix.size(), m_prefix) != 0)
+            return false;
+        name = path.substr(m_prefix.size());
+        return true;
+    }
+};
+
+inline AssetFileSystem& Assets()
+{
+    return AssetFileSystem::getInstance();
+}
+
+#endif // ASSETPACK_H_
@@ -0,0 +1,440 @@
+#ifndef AUDIOMIXER_H_
+#define AUDIOMIXER_H_
+
+#include "SpscRing.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+
+  // All audio is mixed as 16-bit stereo at one sample rate; clips are
+  // converted to it when they are loaded.
+static const int AUDIO_SAMPLE_RATE = 44100;
+static const int AUDIO_CHANNELS = 2;
+
+  // Decodes a WAV file already in memory into interleaved 16-bit stereo at
+  // AUDIO_SAMPLE_RATE.  Handles integer PCM of 8, 16, 24, or 32 bits and
+  // 32-bit float, mono or stereo (only the first two channels of anything
+  // wider are kept), at any sample rate (converted by linear
+  // interpolation).  Chunks other than "fmt " and "data" are skipped.
+class WavDecoder
+{
+  public:
+    static bool decode(const char* data, size_t size, std::vector<std::int16_t>& samples)
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        if (size < 12  ||  std::memcmp(p, "RIFF", 4) != 0  ||  std::memcmp(p + 8, "WAVE", 4) != 0)
+            return false;
+
+        unsigned int format = 0, channels = 0, rate = 0, bits = 0;
+        const unsigned char* pcm = nullptr;
+        size_t pcmBytes = 0;
+        for (size_t pos = 12; pos + 8 <= size; )
+        {
+            size_t chunkSize = readNumber(p + pos + 4, 4);
+            const unsigned char* chunk = p + pos + 8;
+            size_t available = size - pos - 8;
+            if (std::memcmp(p + pos, "fmt ", 4) == 0  &&  chunkSize >= 16  &&  available >= 16)
+            {
+                format = static_cast<unsigned int>(readNumber(chunk, 2));
+                channels = static_cast<unsigned int>(readNumber(chunk + 2, 2));
+                rate = static_cast<unsigned int>(readNumber(chunk + 4, 4));
+                bits = static_cast<unsigned int>(readNumber(chunk + 14, 2));
+                  // WAVE_FORMAT_EXTENSIBLE gives the real format in its subformat
+                if (format == FORMAT_EXTENSIBLE  &&  chunkSize >= 26  &&  available >= 26)
+                    format = static_cast<unsigned int>(readNumber(chunk + 24, 2));
+            }
+            else if (std::memcmp(p + pos, "data", 4) == 0)
+            {
+                  // Some files claim more data than they hold
+                pcm = chunk;
+                pcmBytes = std::min(chunkSize, available);
+                break;
+            }
+            if (chunkSize > available)
+                break;
+            pos += 8 + chunkSize + (chunkSize & 1);
+        }
+
+        bool knownFormat = (format == FORMAT_PCM  &&  (bits == 8  ||  bits == 16  ||  bits == 24  ||  bits == 32))  ||
+                           (format == FORMAT_FLOAT  &&  bits == 32);
+        if (pcm == nullptr  ||  !knownFormat  ||  channels == 0  ||  rate == 0)
+            return false;
+
+        size_t bytesPerSample = bits / 8;
+        size_t frameBytes = bytesPerSample * channels;
+        size_t inFrames = pcmBytes / frameBytes;
+        if (inFrames == 0)
+        {
+            samples.clear();
+            return true;
+        }
+
+          // Step through the input in 32.32 fixed point, interpolating
+          // between neighboring input frames
+        size_t outFrames = static_cast<size_t>((static_cast<std::uint64_t>(inFrames) * AUDIO_SAMPLE_RATE + rate - 1) / rate);
+        std::uint64_t step = (static_cast<std::uint64_t>(rate) << 32) / AUDIO_SAMPLE_RATE;
+        samples.resize(outFrames * AUDIO_CHANNELS);
+        std::uint64_t position = 0;
+        for (size_t k = 0; k < outFrames; k++, position += step)
+        {
+            size_t i = static_cast<size_t>(position >> 32);
+            std::int64_t frac = static_cast<std::int64_t>((position >> 16) & 0xffff);
+            const unsigned char* a = pcm + std::min(i, inFrames - 1) * frameBytes;
+            const unsigned char* b = pcm + std::min(i + 1, inFrames - 1) * frameBytes;
+            for (int c = 0; c < AUDIO_CHANNELS; c++)
+            {
+                size_t offset = std::min<size_t>(c, channels - 1) * bytesPerSample;
+                std::int64_t s0 = readSample(a + offset, format, bits);
+                std::int64_t s1 = readSample(b + offset, format, bits);
+                samples[k * AUDIO_CHANNELS + c] = static_cast<std::int16_t>(s0 + (((s1 - s0) * frac) >> 16));
+            }
+        }
+        return true;
+    }
+
+  private:
+    static const unsigned int FORMAT_PCM = 1;
+    static const unsigned int FORMAT_FLOAT = 3;
+    static const unsigned int FORMAT_EXTENSIBLE = 0xfffe;
+
+    static size_t readNumber(const unsigned char* p, int bytes)
+    {
+        size_t n = 0;
+        for (int k = bytes - 1; k >= 0; k--)
+            n = (n << 8) | p[k];
+        return n;
+    }
+
+      // One sample, scaled to the 16-bit range
+    static std::int64_t readSample(const unsigned char* p, unsigned int format, unsigned int bits)
+    {
+        if (format == FORMAT_FLOAT)
+        {
+            float f;
+            std::memcpy(&f, p, sizeof(f));
+            return static_cast<std::int64_t>(std::max(-1.0f, std::min(1.0f, f)) * 32767);
+        }
+        switch (bits)
+        {
+            case 8:  return (static_cast<int>(p[0]) - 128) * 256;
+              // Wider samples keep their top 16 bits
+            case 16: return static_cast<std::int16_t>(p[0] | (p[1] << 8));
+            case 24: return static_cast<std::int16_t>(p[1] | (p[2] << 8));
+            default: return static_cast<std::int16_t>(p[2] | (p[3] << 8));
+        }
+    }
+};
+
+  // Where mixed audio goes.  The mixer hands write() one block at a time;
+  // a sink that plays sound blocks until the device can take the block,
+  // which is what paces the mixer.
+class AudioSink
+{
+  public:
+    virtual ~AudioSink() {}
+
+      // frames frames of interleaved AUDIO_CHANNELS samples
+    virtual void write(const std::int16_t* samples, size_t frames) = 0;
+};
+
+  // Keeps a sink that has no device to wait for from running ahead of the
+  // clock, so that what it receives lines up with the game in real time
+class AudioPacer
+{
+  public:
+    AudioPacer()
+     : m_start(std::chrono::steady_clock::now()), m_frames(0)
+    {}
+
+    void wait(size_t frames)
+    {
+        m_frames += frames;
+        std::this_thread::sleep_until(m_start + std::chrono::microseconds(m_frames * 1000000 / AUDIO_SAMPLE_RATE));
+    }
+
+  private:
+    std::chrono::steady_clock::time_point m_start;
+    unsigned long long                    m_frames;     // written since m_start
+};
+
+  // Discards the audio, for machines without a sound device or a backend
+  // for it
+class NullAudioSink : public AudioSink
+{
+  public:
+    virtual void write(const std::int16_t*, size_t frames)
+    {
+        m_pacer.wait(frames);
+    }
+
+  private:
+    AudioPacer m_pacer;
+};
+
+  // Records the audio, in real time, to a 16-bit stereo WAV file
+class WavFileAudioSink : public AudioSink
+{
+  public:
+    WavFileAudioSink(std::string filename)
+     : m_file(filename, std::ios::out|std::ios::binary), m_dataBytes(0)
+    {
+        writeHeader();
+    }
+
+    virtual ~WavFileAudioSink()
+    {
+          // Now that the length is known, fill it in
+        m_file.seekp(0);
+        writeHeader();
+    }
+
+    bool isOpen() const
+    {
+        return static_cast<bool>(m_file);
+    }
+
+    virtual void write(const std::int16_t* samples, size_t frames)
+    {
+        m_bytes.resize(frames * AUDIO_CHANNELS * sizeof(std::int16_t));
+        for (size_t k = 0; k < frames * AUDIO_CHANNELS; k++)
+        {
+            m_bytes[2 * k] = static_cast<char>(samples[k] & 0xff);
+            m_bytes[2 * k + 1] = static_cast<char>((samples[k] >> 8) & 0xff);
+        }
+        m_file.write(m_bytes.data(), m_bytes.size());
+        m_dataBytes += m_bytes.size();
+        m_pacer.wait(frames);
+    }
+
+  private:
+    std::ofstream     m_file;
+    std::uint64_t     m_dataBytes;
+    std::vector<char> m_bytes;      // one block, little-endian
+    AudioPacer        m_pacer;
+
+    static void putNumber(std::string& out, std::uint64_t n, int bytes)
+    {
+        for (int k = 0; k < bytes; k++)
+            out += static_cast<char>((n >> (8 * k)) & 0xff);
+    }
+
+    void writeHeader()
+    {
+        const int bytesPerFrame = AUDIO_CHANNELS * sizeof(std::int16_t);
+        std::string header = "RIFF";
+        putNumber(header, 36 + m_dataBytes, 4);
+        header += "WAVEfmt ";
+        putNumber(header, 16, 4);
+        putNumber(header, 1, 2);    // PCM
+        putNumber(header, AUDIO_CHANNELS, 2);
+        putNumber(header, AUDIO_SAMPLE_RATE, 4);
+        putNumber(header, AUDIO_SAMPLE_RATE * bytesPerFrame, 4);
+        putNumber(header, bytesPerFrame, 2);
+        putNumber(header, 16, 2);
+        header += "data";
+        putNumber(header, m_dataBytes, 4);
+        m_file.write(header.data(), header.size());
+    }
+};
+
+  // Plays clips of PCM audio on a fixed pool of voices, mixed on a thread
+  // of its own and written to an AudioSink.  Clips are added before mixing
+  // begins and never change after that, so the audio thread reads them
+  // without locking.  play() and stopAll() only put a command on a
+  // wait-free queue; they must all be called from one thread (the game's
+  // simulation thread).  If the queue is full, the command is dropped.
+class AudioMixer
+{
+  public:
+    static const int MAX_VOICES = 16;
+    static const int MAX_VOICES_PER_CLIP = 4;
+    static const int BLOCK_FRAMES = 256;    // about 6 ms
+
+    AudioMixer()
+     : m_running(false), m_nextStartOrder(0)
+    {
+        for (Voice& v : m_voices)
+            v.clip = NO_CLIP;
+    }
+
+    ~AudioMixer()
+    {
+        stop();
+    }
+
+      // Take a clip of interleaved stereo samples at AUDIO_SAMPLE_RATE and
+      // return its ID.  Only before start(), or from its prepare function.
+    int addClip(std::vector<std::int16_t> samples)
+    {
+        m_clips.push_back(std::move(samples));
+        return static_cast<int>(m_clips.size()) - 1;
+    }
+
+      // Start the audio thread.  If there is a prepare function, it runs
+      // there first, so clips can be decoded and added without holding up
+      // the caller; commands queued meanwhile wait until it is done.
+    void start(std::unique_ptr<AudioSink> sink, std::function<void()> prepare = nullptr)
+    {
+        stop();
+        m_sink = std::move(sink);
+        m_running = true;
+        m_thread = std::thread(&AudioMixer::run, this, std::move(prepare));
+    }
+
+    void stop()
+    {
+        m_running = false;
+        if (m_thread.joinable())
+            m_thread.join();
+        m_sink.reset();
+    }
+
+    bool isRunning() const
+    {
+        return m_thread.joinable();
+    }
+
+      // Start a clip.  If every voice is busy, it cuts off the oldest of
+      // those playing the lowest priority, unless all of them are higher
+      // than priority, in which case it isn't played.  A clip that is
+      // already playing MAX_VOICES_PER_CLIP times restarts its oldest voice.
+    bool play(int clipID, int priority = 0)
+    {
+        return m_commands.push(Command{ clipID, priority });
+    }
+
+    bool stopAll()
+    {
+        return m_commands.push(Command{ STOP_ALL, 0 });
+    }
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+  private:
+    static const int NO_CLIP = -1;
+    static const int STOP_ALL = -1;     // as a command
+    static const size_t COMMAND_QUEUE_SIZE = 64;
+
+    struct Command
+    {
+        int clip;       // or STOP_ALL
+        int priority;
+    };
+
+    struct Voice
+    {
+        int                clip;        // NO_CLIP if the voice is free
+        int                priority;
+        size_t             position;    // next frame to play
+        unsigned long long startOrder;  // when it started, to find the oldest
+    };
+
+    std::vector<std::vector<std::int16_t>>  m_clips;
+    SpscRing<Command, COMMAND_QUEUE_SIZE>   m_commands;
+    std::unique_ptr<AudioSink>              m_sink;
+    std::thread                             m_thread;
+    std::atomic<bool>                       m_running;
+
+      // Touched only by the audio thread
+    Voice                   m_voices[MAX_VOICES];
+    unsigned long long      m_nextStartOrder;
+    std::int32_t            m_mix[BLOCK_FRAMES * AUDIO_CHANNELS];
+    std::int16_t            m_block[BLOCK_FRAMES * AUDIO_CHANNELS];
+
+    void run(std::function<void()> prepare)
+    {
+        if (prepare)
+            prepare();
+        while (m_running)
+        {
+            Command command;
+            while (m_commands.pop(command))
+                doCommand(command);
+            mixBlock();
+            m_sink->write(m_block, BLOCK_FRAMES);
+        }
+    }
+
+    void doCommand(const Command& command)
+    {
+        int clip = command.clip;
+        if (clip == STOP_ALL)
+        {
+            for (Voice& v : m_voices)
+                v.clip = NO_CLIP;
+            return;
+        }
+        if (clip < 0  ||  clip >= static_cast<int>(m_clips.size())  ||  m_clips[clip].empty())
+            return;
+
+          // Use a free voice if there is one.  Otherwise take the oldest
+          // voice of the same clip if it has too many, or else the oldest
+          // of the lowest priority, if that's no higher than this one.
+        Voice* freeVoice = nullptr;
+        Voice* sameClip = nullptr;
+        int sameClipCount = 0;
+        Voice* lowest = nullptr;
+        for (Voice& v : m_voices)
+        {
+            if (v.clip == NO_CLIP)
+            {
+                if (freeVoice == nullptr)
+                    freeVoice = &v;
+                continue;
+            }
+            if (v.clip == clip)
+            {
+                sameClipCount++;
+                if (sameClip == nullptr  ||  v.startOrder < sameClip->startOrder)
+                    sameClip = &v;
+            }
+            if (lowest == nullptr  ||  v.priority < lowest->priority  ||
+                (v.priority == lowest->priority  &&  v.startOrder < lowest->startOrder))
+                lowest = &v;
+        }
+
+        Voice* voice;
+        if (sameClipCount >= MAX_VOICES_PER_CLIP)
+            voice = sameClip;
+        else if (freeVoice != nullptr)
+            voice = freeVoice;
+        else if (lowest != nullptr  &&  lowest->priority <= command.priority)
+            voice = lowest;
+        else
+            return;
+        *voice = Voice{ clip, command.priority, 0, m_nextStartOrder++ };
+    }
+
+    void mixBlock()
+    {
+        std::fill(std::begin(m_mix), std::end(m_mix), 0);
+        for (Voice& v : m_voices)
+        {
+            if (v.clip == NO_CLIP)
+                continue;
+            const std::vector<std::int16_t>& clip = m_clips[v.clip];
+            size_t clipFrames = clip.size() / AUDIO_CHANNELS;
+            size_t frames = std::min<size_t>(BLOCK_FRAMES, clipFrames - v.position);
+            const std::int16_t* src = clip.data() + v.position * AUDIO_CHANNELS;
+            for (size_t k = 0; k < frames * AUDIO_CHANNELS; k++)
+                m_mix[k] += src[k];
+            v.position += frames;
+            if (v.position == clipFrames)
+                v.clip = NO_CLIP;
+        }
+        for (int k = 0; k < BLOCK_FRAMES * AUDIO_CHANNELS; k++)
+            m_block[k] = static_cast<std::int16_t>(std::max(-32768, std::min(32767, m_mix[k])));
+    }
+};
+
+#endif // AUDIOMIXER_H_
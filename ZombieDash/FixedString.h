@@ -0,0 +1,91 @@
+#ifndef FIXEDSTRING_H_
+#define FIXEDSTRING_H_
+
+#include <cstddef>
+#include <cstring>
+
+  // A string of at most N - 1 characters kept in an array of its own, for
+  // text that is rebuilt every tick and so shouldn't touch the heap.
+  // Anything appended beyond the capacity is dropped.
+
+template<std::size_t N>
+class FixedString
+{
+  public:
+    FixedString()
+     : m_length(0)
+    {
+        m_chars[0] = '\0';
+    }
+
+    void clear()
+    {
+        m_length = 0;
+        m_chars[0] = '\0';
+    }
+
+    FixedString& append(char c)
+    {
+        if (m_length + 1 < N)
+        {
+            m_chars[m_length++] = c;
+            m_chars[m_length] = '\0';
+        }
+        return *this;
+    }
+
+    FixedString& append(const char* s)
+    {
+        for ( ; *s != '\0'; s++)
+            append(*s);
+        return *this;
+    }
+
+      // Append n in decimal, as std::to_string would write it, after
+      // enough copies of pad to make it at least width characters long
+    FixedString& appendNumber(int n, int width = 0, char pad = ' ')
+    {
+        char digits[16];
+        int k = sizeof(digits);
+        unsigned int magnitude = (n < 0 ? 0u - static_cast<unsigned int>(n) : static_cast<unsigned int>(n));
+        do
+        {
+            digits[--k] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (n < 0)
+            digits[--k] = '-';
+
+        for (int len = static_cast<int>(sizeof(digits)) - k; len < width; len++)
+            append(pad);
+        for ( ; k < static_cast<int>(sizeof(digits)); k++)
+            append(digits[k]);
+        return *this;
+    }
+
+    const char* c_str() const
+    {
+        return m_chars;
+    }
+
+    std::size_t length() const
+    {
+        return m_length;
+    }
+
+    bool operator==(const FixedString& other) const
+    {
+        return m_length == other.m_length  &&  std::memcmp(m_chars, other.m_chars, m_length) == 0;
+    }
+
+    bool operator!=(const FixedString& other) const
+    {
+        return !(*this == other);
+    }
+
+  private:
+    char        m_chars[N];
+    std::size_t m_length;
+};
+
+#endif // FIXEDSTRING_H_
@@ -5,11 +5,21 @@
 #include "GraphObject.h"
 #include "SoundFX.h"
 #include "SpriteManager.h"
+#include "Profiler.h"
+#include "PerfCounters.h"
+#include "RewindBuffer.h"
+#include "GameplayRecording.h"
+#include "AllocationCounter.h"
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
 #include <utility>
 #include <cstdlib>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
 using namespace std;
 
 /*
@@ -41,7 +51,58 @@ static const double FONT_SCALEDOWN = 760.0;
 static const double SCORE_Y = 3.8;
 static const double SCORE_Z = -10;
 
-static const int MS_PER_FRAME = 5;
+  // The simulation thread advances in fixed ticks of MS_PER_TICK regardless
+  // of how often frames are drawn.  If it falls more than MAX_TICKS_PER_FRAME
+  // ticks behind, the rest of the backlog is dropped (the game slows down
+  // rather than spiraling).  When there is nothing to simulate (e.g. at a
+  // prompt) it polls every SIMULATION_IDLE_MS.
+static const double MS_PER_TICK = 15;
+static const int MAX_TICKS_PER_FRAME = 5;
+static const int SIMULATION_IDLE_MS = 2;
+
+  // In fast-forward mode the simulation runs a batch of ticks each time the
+  // renderer has drawn the last one (or MAX_ANIMATE_WAIT_MS has passed),
+  // and only the batch's last tick is published.  The 'x' key steps
+  // through FAST_FORWARD_SPEEDS: ticks per batch, with FAST_FORWARD_MAX
+  // meaning as many as fit in FAST_FORWARD_BUDGET_MS.
+static const int FAST_FORWARD_MAX = 0;
+static const int FAST_FORWARD_SPEEDS[] = { 1, 4, 16, FAST_FORWARD_MAX };
+static const double FAST_FORWARD_BUDGET_MS = 12;
+
+  // In single-step mode, '[' and ']' step back and forward through the
+  // ticks already played, and '{' and '}' this many at a time
+static const int REWIND_LONG_STEP = 64;
+
+  // Playing a recording back: '[' and ']' step a frame, '{' and '}'
+  // PLAYBACK_LONG_STEP frames, and the left and right arrow keys jump
+  // PLAYBACK_JUMP_SECONDS; 'x' speeds it up as it does the game
+static const int PLAYBACK_LONG_STEP = 64;
+static const int PLAYBACK_JUMP_SECONDS = 10;
+static const int PLAYBACK_MAX_SPEED = 64;
+
+  // Key presses waiting longer than this for a tick are dropped
+static const int MAX_INPUT_AGE_MS = 250;
+
+  // Different sounds started per step at most; the rest are dropped
+static const int MAX_SOUNDS_PER_STEP = 4;
+
+  // Static objects are cached for a region reaching STATIC_REGION_MARGIN
+  // beyond the view on every side; it moves when the view leaves it
+static const double STATIC_REGION_MARGIN = VIEW_WIDTH / 2;
+
+  // How long to wait for the renderer to show the last tick of a life or
+  // level before moving on to the next prompt
+static const int MAX_ANIMATE_WAIT_MS = 100;
+
+  // The texture atlas built from the sprites, mipmaps and all, is kept in
+  // this file in the working directory, so only the first run (or the first
+  // after a sprite changes) has to build it
+static const char* const TEXTURE_CACHE_FILE = "ZombieDash.texcache";
+
+static const double OVERLAY_X = -4.0;
+static const double OVERLAY_Y = 3.4;
+static const double OVERLAY_LINE_SPACING = .22;
+static const double OVERLAY_FONT_SIZE = .55;
 
 struct SpriteInfo
 {
@@ -50,8 +111,9 @@ struct SpriteInfo
     std::string tgaFileName;
 };
 
-static void drawPrompt(string mainMessage, string secondMessage);
-static void drawScoreAndLives(string);
+static void drawPrompt(const StrokeLabel& mainMessage, const StrokeLabel& secondMessage);
+static void drawScoreAndLives(const StrokeLabel& gameStatText);
+static void outputStroke(double x, double y, double z, double size, const char* str);
 
 enum GameController::GameControllerState : int {
     welcome, init, makemove, animate, contgame, finishedlevel, cleanup,
@@ -81,34 +143,73 @@ void GameController::initDrawersAndSounds()
         { IID_WALL           , 0, "wall.tga" },
     };
 
-    SoundMapType::value_type sounds[] = {
-        make_pair(SOUND_PLAYER_FIRE     , "flame.wav"),
-        make_pair(SOUND_PLAYER_DIE      , "die.wav"),
-        make_pair(SOUND_ZOMBIE_BORN     , "born.wav"),
-        make_pair(SOUND_ZOMBIE_VOMIT    , "vomit.wav"),
-        make_pair(SOUND_ZOMBIE_DIE      , "zombiedie.wav"),
-        make_pair(SOUND_CITIZEN_INFECTED, "argh.wav"),
-        make_pair(SOUND_CITIZEN_SAVED   , "woohoo.wav"),
-        make_pair(SOUND_CITIZEN_DIE     , "scream.wav"),
-        make_pair(SOUND_GOT_GOODIE      , "goodie.wav"),
-        make_pair(SOUND_LANDMINE_EXPLODE, "explode.wav"),
-        make_pair(SOUND_LEVEL_FINISHED  , "finished.wav"),
-        make_pair(SOUND_THEME           , "theme.wav"),
+      // A step plays at most MAX_SOUNDS_PER_STEP different sounds, highest
+      // priority first; a higher-priority sound also takes a voice from a
+      // lower one when the mixer has none free
+    struct SoundInfo
+    {
+        int         soundID;
+        int         priority;
+        const char* wavFileName;
+    };
+    SoundInfo sounds[] = {
+        { SOUND_PLAYER_FIRE     , 2, "flame.wav" },
+        { SOUND_PLAYER_DIE      , 3, "die.wav" },
+        { SOUND_ZOMBIE_BORN     , 1, "born.wav" },
+        { SOUND_ZOMBIE_VOMIT    , 1, "vomit.wav" },
+        { SOUND_ZOMBIE_DIE      , 1, "zombiedie.wav" },
+        { SOUND_CITIZEN_INFECTED, 2, "argh.wav" },
+        { SOUND_CITIZEN_SAVED   , 2, "woohoo.wav" },
+        { SOUND_CITIZEN_DIE     , 2, "scream.wav" },
+        { SOUND_GOT_GOODIE      , 2, "goodie.wav" },
+        { SOUND_LANDMINE_EXPLODE, 2, "explode.wav" },
+        { SOUND_LEVEL_FINISHED  , 3, "finished.wav" },
+        { SOUND_THEME           , 3, "theme.wav" },
     };
 
+      // The welcome screen shows no sprites, so they load in the background
+      // while it is up; the first frame of gameplay waits for them
     string path = m_gw->assetPath();
+    m_spriteManager.setTextureCache(TEXTURE_CACHE_FILE);
     for (const SpriteInfo& d : drawers)
     {
         if (!m_spriteManager.loadSprite(path + d.tgaFileName, d.imageID, d.frameNum))
             exit(1);
     }
-    for (const auto& s : sounds)
-        m_soundMap[s.first] = s.second;
+    m_spriteManager.startLoading();
+      // Sounds are decoded up front (on the audio thread), so playing one
+      // is just queuing its clip ID
+    vector<string> soundFiles;
+    for (SoundClip& c : m_soundClips)
+        c = SoundClip{ -1, 0 };
+    for (const SoundInfo& s : sounds)
+    {
+        m_soundClips[s.soundID] = SoundClip{ static_cast<int>(soundFiles.size()), s.priority };
+        soundFiles.push_back(path + s.wavFileName);
+    }
+    unique_ptr<AudioSink> audioSink;
+    if (!m_audioOutputFile.empty())
+        audioSink.reset(new WavFileAudioSink(m_audioOutputFile));
+    SoundFX().start(soundFiles, move(audioSink));
+
+      // These never move, so they are drawn from a cached layer
+    int staticImages[] = { IID_WALL, IID_PIT, IID_EXIT };
+    for (int imageID : staticImages)
+        GraphObject::setStaticImage(imageID);
+
+      // The simulation thread needs frame counts to build snapshots, but must
+      // not touch the sprite manager, so take a copy now
+    for (const SpriteInfo& d : drawers)
+    {
+        if (d.imageID >= static_cast<int>(m_framesPerImage.size()))
+            m_framesPerImage.resize(d.imageID + 1, 0);
+        m_framesPerImage[d.imageID] = m_spriteManager.getNumFrames(d.imageID);
+    }
 }
 
-static void doSomethingCallback()
+static void renderCallback()
 {
-    Game().doSomething();
+    Game().renderFrame();
 }
 
 static void reshapeCallback(int w, int h)
@@ -126,10 +227,19 @@ static void specialKeyboardEventCallback(int key, int x, int y)
     Game().specialKeyboardEvent(key, x, y);
 }
 
-static void timerFuncCallback(int)
+static void idleCallback()
+{
+      // draw as often as the display allows
+    glutPostRedisplay();
+}
+
+  // Defined here, where RewindBuffer and GameplayRecorder are complete types
+GameController::GameController()
+{
+}
+
+GameController::~GameController()
 {
-    Game().doSomething();
-    glutTimerFunc(MS_PER_FRAME, timerFuncCallback, 0);
 }
 
 void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTitle)
@@ -137,13 +247,53 @@ void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTit
     gw->setController(this);
     m_gw = gw;
     setGameState(welcome);
-    m_lastKeyHit = INVALID_KEY;
+    m_tickInput.key = INVALID_KEY;
+    m_pendingInput.id = 0;
+    m_inputsUsed = 0;
+    m_lastInputDisplayed = 0;
     m_singleStep = false;
-    m_curIntraFrameTick = 0;
+    m_fastForward = 1;
+    m_showPerfOverlay = false;
+    m_quitRequested = false;
+    m_simulationFinished = false;
+    m_tickAccumulatorMs = 0;
+    m_rewind.reset(new RewindBuffer);
+    m_rewindTick = 0;
+    m_lastUpdateTime = chrono::steady_clock::now();
+    m_publishedSequence = 0;
+    m_presentedSequence = 0;
+    m_staticLayerVersion = -1;
+    m_assetLoadFailed = false;
+    m_gameStatVersion = 0;
+    m_hudLabelVersion = -1;
+    m_cameraX = m_cameraY = 0;
+    for (double& bound : m_staticRegion)
+        bound = 0;
+    m_staticRegionVersion = 0;
+    m_staticRegionGeneration = -1;
     m_playerWon = false;
 
     glutInit(&argc, argv);
 
+      // glutInit removed its own options; what's left is ours
+    m_audioOutputFile.clear();
+    m_playbackFile.clear();
+    string recordFile;
+    for (int k = 1; k < argc; k++)
+    {
+        if (string(argv[k]) == "--audio-wav"  &&  k + 1 < argc)
+            m_audioOutputFile = argv[++k];
+        else if (string(argv[k]) == "--record"  &&  k + 1 < argc)
+            recordFile = argv[++k];
+        else if (string(argv[k]) == "--play"  &&  k + 1 < argc)
+            m_playbackFile = argv[++k];
+        else if (string(argv[k]) == "--turbo"  &&  k + 1 < argc)
+        {
+            string speed = argv[++k];
+            m_fastForward = (speed == "max" ? FAST_FORWARD_MAX : max(1, atoi(speed.c_str())));
+        }
+    }
+
     glutInitDisplayMode(GLUT_RGB | GLUT_DEPTH | GLUT_DOUBLE);
     glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
     glutInitWindowPosition(0, 0);
@@ -154,27 +304,79 @@ void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTit
     glutKeyboardFunc(keyboardEventCallback);
     glutSpecialFunc(specialKeyboardEventCallback);
     glutReshapeFunc(reshapeCallback);
-    glutDisplayFunc(doSomethingCallback);
-    glutTimerFunc(MS_PER_FRAME, timerFuncCallback, 0);
+    glutDisplayFunc(renderCallback);
+    glutIdleFunc(idleCallback);
 
     glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+
+    if (!recordFile.empty()  &&  m_playbackFile.empty())
+    {
+        m_recorder.reset(new GameplayRecorder);
+        if (!m_recorder->start(recordFile))
+            cout << "Cannot write recording " << recordFile << endl;
+    }
+
+      // The game runs on its own thread from here on; this thread only
+      // handles input and draws what the simulation publishes
+    m_simulationThread = thread(m_playbackFile.empty() ? &GameController::simulationLoop :
+                                                         &GameController::playbackLoop, this);
     glutMainLoop();
+
+      // The window may have been closed while the game was still running
+    m_quitRequested = true;
+    m_simulationThread.join();
+    if (m_recorder  &&  m_recorder->isRecording())
+    {
+        m_recorder->stop();
+        cout << "Recorded " << m_recorder->numFrames() << " frames to " << recordFile;
+        if (m_recorder->droppedFrames() > 0)
+            cout << " (" << m_recorder->droppedFrames() << " dropped)";
+        cout << endl;
+    }
+    SoundFX().stop();
     delete m_gw;
+    if (m_assetLoadFailed)
+        exit(1);
 }
 
 void GameController::keyboardEvent(unsigned char key, int /* x */, int /* y */)
 {
     switch (key)
     {
-        case 'a': case '4': m_lastKeyHit = KEY_PRESS_LEFT;  break;
-        case 'd': case '6': m_lastKeyHit = KEY_PRESS_RIGHT; break;
-        case 'w': case '8': m_lastKeyHit = KEY_PRESS_UP;    break;
-        case 's': case '2': m_lastKeyHit = KEY_PRESS_DOWN;  break;
-        case 't':           m_lastKeyHit = KEY_PRESS_TAB;   break;
-        case 'f':           m_singleStep = true;            break;
-        case 'r':           m_singleStep = false;           break;
-        case 'q': case 'Q': quitGame();                     break;
-        default:            m_lastKeyHit = key;             break;
+        case 'a': case '4': postInputEvent(KEY_PRESS_LEFT);  break;
+        case 'd': case '6': postInputEvent(KEY_PRESS_RIGHT); break;
+        case 'w': case '8': postInputEvent(KEY_PRESS_UP);    break;
+        case 's': case '2': postInputEvent(KEY_PRESS_DOWN);  break;
+        case 't':           postInputEvent(KEY_PRESS_TAB);   break;
+        case 'f':           m_singleStep = true;             break;
+        case '[': case '{':     // pause, then step back
+            m_singleStep = true;
+            postInputEvent(key);
+            break;
+        case 'r':           m_singleStep = false;            break;
+        case 'x':
+            {
+                const int numSpeeds = sizeof(FAST_FORWARD_SPEEDS) / sizeof(FAST_FORWARD_SPEEDS[0]);
+                int k = 0;
+                while (k < numSpeeds  &&  FAST_FORWARD_SPEEDS[k] != m_fastForward)
+                    k++;
+                m_fastForward = FAST_FORWARD_SPEEDS[(k + 1) % numSpeeds];
+            }
+            break;
+        case 'o':           m_showPerfOverlay = !m_showPerfOverlay; break;
+        case 'l':
+            Perf().inputToTick.dump(cout, "key press to tick");
+            Perf().inputToDisplay.dump(cout, "key press to display");
+            cout << flush;
+            break;
+#ifdef ZOMBIEDASH_PROFILE
+        case 'p':
+            if (Profile().writeChromeTrace("zombiedash_trace.json"))
+                cout << "Profile written to zombiedash_trace.json" << endl;
+            break;
+#endif
+        case 'q': case 'Q': quitGame();                      break;
+        default:            postInputEvent(key);             break;
     }
 }
 
@@ -182,25 +384,72 @@ void GameController::specialKeyboardEvent(int key, int /* x */, int /* y */)
 {
     switch (key)
     {
-        case GLUT_KEY_LEFT:  m_lastKeyHit = KEY_PRESS_LEFT;  break;
-        case GLUT_KEY_RIGHT: m_lastKeyHit = KEY_PRESS_RIGHT; break;
-        case GLUT_KEY_UP:    m_lastKeyHit = KEY_PRESS_UP;    break;
-        case GLUT_KEY_DOWN:  m_lastKeyHit = KEY_PRESS_DOWN;  break;
-        default:             m_lastKeyHit = INVALID_KEY;     break;
+        case GLUT_KEY_LEFT:  postInputEvent(KEY_PRESS_LEFT);  break;
+        case GLUT_KEY_RIGHT: postInputEvent(KEY_PRESS_RIGHT); break;
+        case GLUT_KEY_UP:    postInputEvent(KEY_PRESS_UP);    break;
+        case GLUT_KEY_DOWN:  postInputEvent(KEY_PRESS_DOWN);  break;
+        default:                                              break;
     }
 }
 
-void GameController::playSound(int soundID)
+  // GLUT thread.  If the simulation has fallen so far behind that the
+  // queue is full, the new press is dropped.
+void GameController::postInputEvent(int key)
 {
-    if (soundID == SOUND_NONE)
+    m_inputEvents.push(InputEvent{ key, chrono::steady_clock::now() });
+}
+
+  // Simulation thread, at the start of each tick (and each step at a
+  // prompt or in single-step mode).  The tick gets the oldest key press
+  // not yet used, so keys typed faster than the tick rate play out over
+  // the following ticks instead of overwriting each other.  A press older
+  // than MAX_INPUT_AGE_MS is thrown away rather than acted on that late,
+  // and one the last tick didn't ask for doesn't carry over.
+void GameController::takeInputEvent()
+{
+    m_tickInput.key = INVALID_KEY;
+    chrono::steady_clock::time_point oldest = chrono::steady_clock::now() - chrono::milliseconds(MAX_INPUT_AGE_MS);
+    InputEvent e;
+    while (m_inputEvents.pop(e))
+    {
+        if (e.time >= oldest)
+        {
+            m_tickInput = e;
+            return;
+        }
+    }
+}
+
+  // Hand the mixer what playSound() collected during this step: a stop
+  // first if one was asked for, then each sound asked for, best first.
+  // However many times a landmine chain asks for an explosion, it is
+  // started once.
+void GameController::flushSounds()
+{
+    if (m_stopSoundsRequested)
     {
         SoundFX().abortClip();
-        return;
+        m_stopSoundsRequested = false;
     }
+    if (m_soundRequests == 0)
+        return;
 
-    SoundMapType::const_iterator p = m_soundMap.find(soundID);
-    if (p != m_soundMap.end())
-        SoundFX().playClip(m_gw->assetPath() + p->second);
+    SoundClip toPlay[MAX_SOUND_IDS];
+    int count = 0;
+    for (int id = 0; id < MAX_SOUND_IDS; id++)
+    {
+        if ((m_soundRequests & (1u << id))  &&  m_soundClips[id].clip >= 0)
+        {
+              // insertion sort by priority, highest first
+            int k = count++;
+            for ( ; k > 0  &&  toPlay[k-1].priority < m_soundClips[id].priority; k--)
+                toPlay[k] = toPlay[k-1];
+            toPlay[k] = m_soundClips[id];
+        }
+    }
+    m_soundRequests = 0;
+    for (int k = 0; k < count  &&  k < MAX_SOUNDS_PER_STEP; k++)
+        SoundFX().playClip(toPlay[k].clip, toPlay[k].priority);
 }
 
 void GameController::setGameState(GameControllerState s)
@@ -216,15 +465,141 @@ void GameController::setGameStateAfterPrompting(GameControllerState s,
     m_secondMessage = secondMessage;
     m_nextStateAfterPrompt = s;
     setGameState(prompt);
+    publishPromptSnapshot();
 }
 
+  // May be called from either thread; the simulation thread acts on it
+  // at the start of its next step
 void GameController::quitGame()
 {
-    setGameState(quit);
+    m_quitRequested = true;
+}
+
+void GameController::simulationLoop()
+{
+    m_lastUpdateTime = chrono::steady_clock::now();
+    for (;;)
+    {
+        if (m_quitRequested)
+            setGameState(quit);
+        bool quitting = (m_gameState == quit);
+        doSomething();
+        if (quitting)
+            break;
+
+          // While playing in real time, sleep until the next tick is due
+        int sleepMs = SIMULATION_IDLE_MS;
+        if (m_gameState == makemove  &&  !m_singleStep  &&  m_fastForward == 1)
+            sleepMs = max(0, static_cast<int>(MS_PER_TICK - m_tickAccumulatorMs));
+        else if (m_gameState == makemove  &&  !m_singleStep  &&  m_presentedSequence >= m_publishedSequence)
+            sleepMs = 0;    // fast-forward, and the renderer is ready for more
+        this_thread::sleep_for(chrono::milliseconds(sleepMs));
+    }
+    m_simulationFinished = true;
+}
+
+  // Run on the simulation thread in place of simulationLoop when there's
+  // a recording to show.  Frames play at one per tick, and only the frame
+  // shown is ever decoded.
+void GameController::playbackLoop()
+{
+    GameplayPlayback playback;
+    if (!playback.open(m_playbackFile)  ||  playback.numFrames() == 0)
+    {
+        cout << "Cannot play recording " << m_playbackFile << endl;
+        m_simulationFinished = true;
+        return;
+    }
+
+    RecordedFrame frame;
+    long long shown = -1;
+    long long target = 0;
+    double accumulatorMs = 0;
+    m_lastUpdateTime = chrono::steady_clock::now();
+    while (!m_quitRequested)
+    {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        double elapsedMs = chrono::duration<double, milli>(now - m_lastUpdateTime).count();
+        m_lastUpdateTime = now;
+
+        int key;
+        takeInputEvent();
+        if (getLastKey(key))
+        {
+            const long long jump = static_cast<long long>(PLAYBACK_JUMP_SECONDS * 1000 / MS_PER_TICK);
+            switch (key)
+            {
+                case '[':               target -= 1;                   break;
+                case ']':               target += 1;                   break;
+                case '{':               target -= PLAYBACK_LONG_STEP;  break;
+                case '}':               target += PLAYBACK_LONG_STEP;  break;
+                case KEY_PRESS_LEFT:    target -= jump;                break;
+                case KEY_PRESS_RIGHT:   target += jump;                break;
+                default:                                               break;
+            }
+            accumulatorMs = 0;
+        }
+        else if (!m_singleStep)
+        {
+            int speed = (m_fastForward == FAST_FORWARD_MAX ? PLAYBACK_MAX_SPEED : m_fastForward.load());
+            accumulatorMs += elapsedMs * speed;
+            long long due = static_cast<long long>(accumulatorMs / MS_PER_TICK);
+            target += due;
+            accumulatorMs -= due * MS_PER_TICK;
+        }
+        target = max(0LL, min(target, playback.numFrames() - 1));
+
+        if (target != shown)
+        {
+            PROFILE_SCOPE("show recorded frame");
+            if (!playback.seek(target, frame))
+            {
+                cout << "Recording " << m_playbackFile << " is damaged at frame " << target << endl;
+                break;
+            }
+            publishRecordedFrame(frame);
+            shown = target;
+        }
+        this_thread::sleep_for(chrono::milliseconds(SIMULATION_IDLE_MS));
+    }
+    m_simulationFinished = true;
+}
+
+void GameController::publishRecordedFrame(const RecordedFrame& frame)
+{
+    setGameStatText(frame.hudText.c_str());
+
+    RenderSnapshot& snapshot = m_snapshots.back();
+    snapshot.mode = RenderSnapshot::mode_gameplay;
+    snapshot.sequence = ++m_publishedSequence;
+    snapshot.interpolate = false;
+    snapshot.publishTime = chrono::steady_clock::now();
+    snapshot.input.id = 0;
+    if (snapshot.hudVersion != m_gameStatVersion)
+    {
+        snapshot.hudText = m_gameStatText;
+        snapshot.hudVersion = m_gameStatVersion;
+    }
+    snapshot.cameraFromX = snapshot.cameraX = frame.cameraX;
+    snapshot.cameraFromY = snapshot.cameraY = frame.cameraY;
+    snapshot.sprites = frame.sprites;
+    if (snapshot.staticVersion != frame.staticVersion)
+    {
+        snapshot.staticSprites = frame.staticSprites;
+        snapshot.staticVersion = frame.staticVersion;
+    }
+    m_snapshots.publish();
 }
 
 void GameController::doSomething()
 {
+    PROFILE_TICK();
+    PROFILE_SCOPE("GameController::doSomething");
+
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    double elapsedMs = chrono::duration<double, milli>(now - m_lastUpdateTime).count();
+    m_lastUpdateTime = now;
+
     switch (m_gameState)
     {
         case not_applicable:
@@ -236,7 +611,7 @@ void GameController::doSomething()
         case init:
             {
                 int status = m_gw->init();
-                SoundFX().abortClip();
+                playSound(SOUND_NONE);
                 if (status == GWSTATUS_PLAYER_WON)
                 {
                     m_playerWon = true;
@@ -249,42 +624,74 @@ void GameController::doSomething()
                         "Press Enter to quit...");
                 }
                 else
+                {
+                      // start the new level's camera where it belongs rather
+                      // than sliding it over from the last one
+                    double fromX, fromY;
+                    updateCamera(fromX, fromY);
+                    m_tickAccumulatorMs = 0;
+                    m_rewind->clear();
+                    m_rewindTick = 0;
+                    recordRewindState();
                     setGameState(makemove);
+                }
             }
             break;
         case makemove:
-            m_curIntraFrameTick = ANIMATION_POSITIONS_PER_TICK;
-            m_nextStateAfterAnimate = not_applicable;
             {
-                int status = m_gw->move();
-                if (status == GWSTATUS_PLAYER_DIED)
+                PROFILE_SCOPE("makemove");
+                if (m_singleStep)
                 {
-                      // animate one last frame so the player can see what happened
-                    m_nextStateAfterAnimate = (m_gw->isGameOver() ? gameover : contgame);
+                      // one tick per key press, or a step through the
+                      // ticks already played
+                    m_tickAccumulatorMs = 0;
+                    int key;
+                    takeInputEvent();
+                    if (getLastKey(key))
+                    {
+                        switch (key)
+                        {
+                            case '[': seekRewind(m_rewindTick - 1);                 break;
+                            case ']': seekRewind(m_rewindTick + 1);                 break;
+                            case '{': seekRewind(m_rewindTick - REWIND_LONG_STEP);  break;
+                            case '}': seekRewind(m_rewindTick + REWIND_LONG_STEP);  break;
+                            default:  runTick();                                    break;
+                        }
+                    }
                 }
-                else if (status == GWSTATUS_FINISHED_LEVEL)
+                else if (m_fastForward != 1)
                 {
-                    m_gw->advanceToNextLevel();
-                      // animate one last frame so the player can see what happened
-                    m_nextStateAfterAnimate = finishedlevel;
+                    m_tickAccumulatorMs = 0;
+                    if (m_presentedSequence >= m_publishedSequence  ||
+                        chrono::duration<double, milli>(now - m_lastBatchTime).count() > MAX_ANIMATE_WAIT_MS)
+                    {
+                        m_lastBatchTime = now;
+                        runFastForwardBatch(m_fastForward);
+                    }
                 }
-            }
-            setGameState(animate);
-            break;
-        case animate:
-            displayGamePlay();
-            if (m_curIntraFrameTick-- <= 0)
-            {
-                if (m_nextStateAfterAnimate != not_applicable)
-                    setGameState(m_nextStateAfterAnimate);
                 else
                 {
-                    int key;
-                    if (!m_singleStep  ||  getLastKey(key))
-                        setGameState(makemove);
+                    m_tickAccumulatorMs += elapsedMs;
+                    for (int ticks = 0; m_tickAccumulatorMs >= MS_PER_TICK  &&  m_gameState == makemove; ticks++)
+                    {
+                        if (ticks == MAX_TICKS_PER_FRAME)
+                        {
+                            m_tickAccumulatorMs = 0;    // too far behind; drop the backlog
+                            break;
+                        }
+                        runTick();
+                        m_tickAccumulatorMs -= MS_PER_TICK;
+                    }
                 }
             }
             break;
+        case animate:
+              // let the renderer show the last tick so the player can see
+              // what happened, but don't wait on it forever
+            if (m_presentedSequence >= m_publishedSequence  ||
+                chrono::duration<double, milli>(now - m_animateStartTime).count() > MAX_ANIMATE_WAIT_MS)
+                setGameState(m_nextStateAfterAnimate);
+            break;
         case contgame:
             setGameStateAfterPrompting(cleanup, "You lost a life!",
                                         "Press Enter to continue playing...");
@@ -307,22 +714,298 @@ void GameController::doSomething()
             }
             break;
         case prompt:
-            drawPrompt(m_mainMessage, m_secondMessage);
             {
                 int key;
+                takeInputEvent();
                 if (getLastKey(key) && key == '\r')
                     setGameState(m_nextStateAfterPrompt);
             }
             break;
         case quit:
-            SoundFX().abortClip();
-            glutLeaveMainLoop();
+            playSound(SOUND_NONE);
             break;
     }
+
+      // All the ticks of this step finish at the same moment, so their
+      // sounds go out together
+    flushSounds();
 }
 
-void GameController::displayGamePlay()
+  // Run ticks ticks (or, for FAST_FORWARD_MAX, as many as fit in
+  // FAST_FORWARD_BUDGET_MS), of which only the last is drawn
+void GameController::runFastForwardBatch(int ticks)
 {
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::now() +
+            chrono::microseconds(static_cast<long long>(FAST_FORWARD_BUDGET_MS * 1000));
+    for (int k = 1; m_gameState == makemove; k++)
+    {
+        bool last = (ticks == FAST_FORWARD_MAX ? chrono::steady_clock::now() >= deadline : k >= ticks);
+        runTick(last);
+        if (last)
+            break;
+    }
+}
+
+  // Advance the world by one fixed-length tick.  A tick that isn't shown
+  // isn't published (unless it ends the level or a life).
+void GameController::runTick(bool shown)
+{
+      // Going on from a tick stepped back to replaces the ticks after it
+    if (m_rewindTick < m_rewind->lastTick())
+        m_rewind->truncateAfter(m_rewindTick);
+
+    m_gw->scene().advanceTick();
+    takeInputEvent();
+
+    InputEvent input = m_tickInput;
+    long long allocationsBefore = AllocationCounter::allocations();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    m_gw->setTickShown(shown);
+    int status = m_gw->move();
+    Perf().tickTime.record(chrono::duration_cast<chrono::microseconds>(
+                                chrono::steady_clock::now() - start).count());
+
+      // Recording the tick for rewind is part of every tick too, so it
+      // counts toward the tick's allocations
+    if (status == GWSTATUS_CONTINUE_GAME)
+    {
+        m_rewindTick++;
+        recordRewindState();
+    }
+    Perf().setTickAllocations(AllocationCounter::allocations() - allocationsBefore);
+
+      // If the world used this tick's key press, time it from here to the
+      // screen (see stampInput)
+    if (input.key != INVALID_KEY  &&  m_tickInput.key == INVALID_KEY)
+    {
+        Perf().inputToTick.record(chrono::duration_cast<chrono::microseconds>(
+                                      m_tickInputUsedTime - input.time).count());
+        m_pendingInput = InputStamp{ ++m_inputsUsed, input.time };
+        m_pendingInputSequence = 0;
+    }
+
+    if (shown  ||  status != GWSTATUS_CONTINUE_GAME)
+        publishGameplaySnapshot(!m_singleStep  &&  m_fastForward == 1);
+
+    if (status == GWSTATUS_PLAYER_DIED)
+    {
+        m_nextStateAfterAnimate = (m_gw->isGameOver() ? gameover : contgame);
+        m_animateStartTime = chrono::steady_clock::now();
+        setGameState(animate);
+    }
+    else if (status == GWSTATUS_FINISHED_LEVEL)
+    {
+        m_gw->advanceToNextLevel();
+        m_nextStateAfterAnimate = finishedlevel;
+        m_animateStartTime = chrono::steady_clock::now();
+        setGameState(animate);
+    }
+}
+
+  // Remember the world as the tick m_rewindTick left it
+void GameController::recordRewindState()
+{
+    PROFILE_SCOPE("recordRewindState");
+    if (m_gw->saveState(m_rewindState))
+    {
+        m_rewindState.tick = m_rewindTick;
+        m_rewind->record(m_rewindState);
+    }
+}
+
+  // Put the world back the way it was after tick, as far as the rewind
+  // buffer goes in either direction.  Stepping forward from the newest
+  // tick it has plays a new one.
+void GameController::seekRewind(long long tick)
+{
+    if (m_rewind->empty())
+        return;
+    if (tick > m_rewind->lastTick()  &&  m_rewindTick == m_rewind->lastTick())
+    {
+        runTick();
+        return;
+    }
+    tick = max(m_rewind->firstTick(), min(tick, m_rewind->lastTick()));
+    if (tick == m_rewindTick)
+        return;
+
+    PROFILE_SCOPE("seekRewind");
+    m_gw->scene().advanceTick();
+    if (m_rewind->seek(tick, m_rewindState)  &&  m_gw->restoreState(m_rewindState))
+    {
+        m_rewindTick = tick;
+        publishGameplaySnapshot(false);
+    }
+}
+
+  // Keep the camera's focus centered, as far as the world's edges allow,
+  // and move the static region along with it.  Reports where the camera
+  // was before this tick.
+void GameController::updateCamera(double& fromX, double& fromY)
+{
+    fromX = m_cameraX;
+    fromY = m_cameraY;
+
+    double focusX, focusY, worldWidth, worldHeight;
+    m_gw->getCameraFocus(focusX, focusY);
+    m_gw->getWorldSize(worldWidth, worldHeight);
+    m_cameraX = max(0.0, min(focusX - VIEW_WIDTH / 2, worldWidth - VIEW_WIDTH));
+    m_cameraY = max(0.0, min(focusY - VIEW_HEIGHT / 2, worldHeight - VIEW_HEIGHT));
+
+    bool viewInRegion = m_cameraX >= m_staticRegion[0]  &&  m_cameraY >= m_staticRegion[1]  &&
+                        m_cameraX + VIEW_WIDTH <= m_staticRegion[2]  &&
+                        m_cameraY + VIEW_HEIGHT <= m_staticRegion[3];
+    if (!viewInRegion  ||  m_staticRegionGeneration != m_gw->scene().staticGeneration())
+    {
+        m_staticRegion[0] = m_cameraX - STATIC_REGION_MARGIN;
+        m_staticRegion[1] = m_cameraY - STATIC_REGION_MARGIN;
+        m_staticRegion[2] = m_cameraX + VIEW_WIDTH + STATIC_REGION_MARGIN;
+        m_staticRegion[3] = m_cameraY + VIEW_HEIGHT + STATIC_REGION_MARGIN;
+        m_staticRegionGeneration = m_gw->scene().staticGeneration();
+        m_staticRegionVersion++;
+    }
+}
+
+  // Capture everything needed to draw the world as the latest tick left it.
+  // The snapshot's vectors and strings are reused, so once they have grown
+  // to fit a level this doesn't allocate.
+void GameController::publishGameplaySnapshot(bool interpolate)
+{
+    PROFILE_SCOPE("publishGameplaySnapshot");
+
+    RenderSnapshot& snapshot = m_snapshots.back();
+    snapshot.mode = RenderSnapshot::mode_gameplay;
+    snapshot.sequence = ++m_publishedSequence;
+    snapshot.interpolate = interpolate;
+    snapshot.publishTime = chrono::steady_clock::now();
+    stampInput(snapshot);
+    if (snapshot.hudVersion != m_gameStatVersion)
+    {
+        snapshot.hudText = m_gameStatText;
+        snapshot.hudVersion = m_gameStatVersion;
+    }
+
+    auto collectInto = [this](vector<SpriteInstance>& sprites)
+    {
+        return [this, &sprites](int imageID, int animationNumber, double fromX, double fromY,
+                                double x, double y, int direction, double size, int depth, long long serial)
+        {
+            int numFrames = (imageID >= 0  &&  imageID < static_cast<int>(m_framesPerImage.size()) ?
+                                    m_framesPerImage[imageID] : 0);
+            SpriteInstance s;
+            s.imageID = imageID;
+            s.frame = (numFrames > 0 ? animationNumber % numFrames : 0);
+            s.fromX = fromX;
+            s.fromY = fromY;
+            s.x = x;
+            s.y = y;
+            s.direction = direction;
+            s.size = size;
+            s.depth = depth;
+            s.serial = serial;
+            sprites.push_back(s);
+        };
+    };
+
+    updateCamera(snapshot.cameraFromX, snapshot.cameraFromY);
+    snapshot.cameraX = m_cameraX;
+    snapshot.cameraY = m_cameraY;
+
+      // Only what the view can show at some point during the tick
+    snapshot.sprites.clear();
+    m_gw->scene().drawDynamicObjects(min(snapshot.cameraFromX, m_cameraX), min(snapshot.cameraFromY, m_cameraY),
+                                     max(snapshot.cameraFromX, m_cameraX) + VIEW_WIDTH,
+                                     max(snapshot.cameraFromY, m_cameraY) + VIEW_HEIGHT,
+                                     collectInto(snapshot.sprites));
+
+      // This buffer may have last been used for another static region, or
+      // before the static objects changed
+    if (snapshot.staticVersion != m_staticRegionVersion)
+    {
+        snapshot.staticSprites.clear();
+        m_gw->scene().drawStaticObjects(m_staticRegion[0], m_staticRegion[1], m_staticRegion[2], m_staticRegion[3],
+                                        collectInto(snapshot.staticSprites));
+        snapshot.staticVersion = m_staticRegionVersion;
+    }
+
+    if (m_recorder  &&  m_recorder->isRecording())
+        m_recorder->addFrame(snapshot);
+    m_snapshots.publish();
+}
+
+  // A snapshot carries the last key press a tick used until one that
+  // carries it has been drawn, since the render thread skips snapshots
+  // when the simulation gets ahead of it.  The first frame swapped with it
+  // ends its measurement.
+void GameController::stampInput(RenderSnapshot& snapshot)
+{
+    if (m_pendingInput.id != 0  &&  m_pendingInputSequence != 0  &&
+        m_presentedSequence >= m_pendingInputSequence)
+        m_pendingInput.id = 0;
+    if (m_pendingInput.id != 0  &&  m_pendingInputSequence == 0)
+        m_pendingInputSequence = snapshot.sequence;
+    snapshot.input = m_pendingInput;
+}
+
+void GameController::publishPromptSnapshot()
+{
+    RenderSnapshot& snapshot = m_snapshots.back();
+    snapshot.mode = RenderSnapshot::mode_prompt;
+    snapshot.sequence = ++m_publishedSequence;
+    snapshot.interpolate = false;
+    snapshot.publishTime = chrono::steady_clock::now();
+    snapshot.input.id = 0;
+    snapshot.mainMessage = m_mainMessage;
+    snapshot.secondMessage = m_secondMessage;
+    m_snapshots.publish();
+}
+
+void GameController::renderFrame()
+{
+    PROFILE_SCOPE("GameController::renderFrame");
+
+    if (m_simulationFinished)
+    {
+        glutLeaveMainLoop();
+        return;
+    }
+
+    m_snapshots.acquire();
+    const RenderSnapshot& snapshot = m_snapshots.front();
+    switch (snapshot.mode)
+    {
+        case RenderSnapshot::mode_blank:
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glutSwapBuffers();
+            break;
+        case RenderSnapshot::mode_prompt:
+            m_mainMessageLabel.setText(snapshot.mainMessage);
+            m_secondMessageLabel.setText(snapshot.secondMessage);
+            drawPrompt(m_mainMessageLabel, m_secondMessageLabel);
+            break;
+        case RenderSnapshot::mode_gameplay:
+            displayGamePlay(snapshot);
+            break;
+    }
+    m_presentedSequence = snapshot.sequence;
+}
+
+void GameController::displayGamePlay(const RenderSnapshot& snapshot)
+{
+    PROFILE_SCOPE("GameController::displayGamePlay");
+
+      // Draw sprites partway between where the tick found them (alpha = 0)
+      // and where it left them (alpha = 1), according to how much of the
+      // next tick has elapsed in real time
+    double alpha = 1;
+    if (snapshot.interpolate)
+    {
+        alpha = chrono::duration<double, milli>(chrono::steady_clock::now() - snapshot.publishTime).count() / MS_PER_TICK;
+        alpha = min(1.0, max(0.0, alpha));
+    }
+    m_spriteManager.setCamera(snapshot.cameraFromX + (snapshot.cameraX - snapshot.cameraFromX) * alpha,
+                              snapshot.cameraFromY + (snapshot.cameraY - snapshot.cameraFromY) * alpha);
+
     glEnable(GL_DEPTH_TEST); // must be done each time before displaying graphics or gets disabled for some reason
     glLoadIdentity();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -335,20 +1018,116 @@ void GameController::displayGamePlay()
 #pragma GCC diagnostic pop
 #endif
 
-    GraphObject::drawAllObjects(
-        [=](int imageID, int animationNumber, double x, double y, int angle, double size)
+    if (!m_spriteManager.finishLoading()  &&  !m_assetLoadFailed)
+    {
+        m_assetLoadFailed = true;
+        quitGame();
+    }
+
+    {
+        PROFILE_SCOPE("drawSprites");
+        m_spriteManager.beginBatch();
+        if (!m_spriteManager.hasStaticLayer()  ||  snapshot.staticVersion != m_staticLayerVersion)
+        {
+            PROFILE_SCOPE("rebuild static layer");
+            m_spriteManager.beginStaticLayer();
+            for (const SpriteInstance& s : snapshot.staticSprites)
+                m_spriteManager.addStaticSprite(s.imageID, s.frame, s.x, s.y, s.direction, s.size, s.depth);
+            m_spriteManager.endStaticLayer();
+            m_staticLayerVersion = snapshot.staticVersion;
+        }
+        for (const SpriteInstance& s : snapshot.sprites)
         {
-            int frame = animationNumber % m_spriteManager.getNumFrames(imageID);
-            m_spriteManager.plotSprite(imageID, frame, x, y, angle, size);
-        });
+            double x = s.fromX + (s.x - s.fromX) * alpha;
+            double y = s.fromY + (s.y - s.fromY) * alpha;
+            m_spriteManager.addSprite(s.imageID, s.frame, x, y, s.direction, s.size, s.depth);
+        }
+        m_spriteManager.drawBatch();
+    }
+    {
+        PROFILE_SCOPE("drawScoreAndLives");
+        if (snapshot.hudVersion != m_hudLabelVersion)
+        {
+            m_hudLabel.setText(snapshot.hudText);
+            m_hudLabelVersion = snapshot.hudVersion;
+        }
+        drawScoreAndLives(m_hudLabel);
+    }
+    if (m_showPerfOverlay)
+    {
+        PROFILE_SCOPE("drawPerfOverlay");
+        drawPerfOverlay();
+    }
+    {
+        PROFILE_SCOPE("glutSwapBuffers");
+        glutSwapBuffers();
+    }
 
-    drawScoreAndLives(m_gameStatText);
+      // frame time is measured swap to swap
+    static chrono::steady_clock::time_point lastSwap = chrono::steady_clock::now();
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (snapshot.input.id > m_lastInputDisplayed)
+    {
+        Perf().inputToDisplay.record(chrono::duration_cast<chrono::microseconds>(now - snapshot.input.received).count());
+        m_lastInputDisplayed = snapshot.input.id;
+    }
+    Perf().frameTime.record(chrono::duration_cast<chrono::microseconds>(now - lastSwap).count());
+    Perf().endFrame();
+    lastSwap = now;
+}
 
-    glutSwapBuffers();
+void GameController::drawPerfOverlay()
+{
+    static const struct { int imageID; const char* label; } actorTypes[] = {
+        { IID_PLAYER, "player" }, { IID_ZOMBIE, "zombie" }, { IID_CITIZEN, "citizen" },
+        { IID_FLAME, "flame" }, { IID_VOMIT, "vomit" }, { IID_PIT, "pit" },
+        { IID_LANDMINE, "mine" }, { IID_VACCINE_GOODIE, "vaccine" },
+        { IID_GAS_CAN_GOODIE, "gascan" }, { IID_LANDMINE_GOODIE, "minegoodie" },
+        { IID_EXIT, "exit" }, { IID_WALL, "wall" },
+    };
+
+    const int NUM_LINES = 6;
+    char line[NUM_LINES][256];
+    int last, p50, p99;
+    Perf().frameTime.summarize(last, p50, p99);
+    snprintf(line[0], sizeof(line[0]), "frame %6.2f ms  p50 %6.2f  p99 %6.2f",
+             last / 1000.0, p50 / 1000.0, p99 / 1000.0);
+    Perf().tickTime.summarize(last, p50, p99);
+    snprintf(line[1], sizeof(line[1]), "tick  %6.2f ms  p50 %6.2f  p99 %6.2f",
+             last / 1000.0, p50 / 1000.0, p99 / 1000.0);
+    snprintf(line[2], sizeof(line[2]), "sprites %d  draw calls %d  texture binds %d  state changes %d",
+             Perf().spritesLastFrame(), Perf().drawCallsLastFrame(), Perf().textureBindsLastFrame(),
+             Perf().stateChangesLastFrame());
+    int fastForward = m_fastForward;
+    if (fastForward == FAST_FORWARD_MAX)
+        snprintf(line[3], sizeof(line[3]), "tick allocs %lld  fast forward max", Perf().tickAllocations());
+    else
+        snprintf(line[3], sizeof(line[3]), "tick allocs %lld  fast forward %dx", Perf().tickAllocations(), fastForward);
+    const LatencyHistogram& toTick = Perf().inputToTick;
+    const LatencyHistogram& toDisplay = Perf().inputToDisplay;
+    snprintf(line[4], sizeof(line[4]), "input->tick p50 %6.2f p99 %6.2f  input->display p50 %6.2f p99 %6.2f max %6.2f ms (%lld keys)",
+             toTick.valueAtPercentile(50) / 1000.0, toTick.valueAtPercentile(99) / 1000.0,
+             toDisplay.valueAtPercentile(50) / 1000.0, toDisplay.valueAtPercentile(99) / 1000.0,
+             toDisplay.maxValue() / 1000.0, toDisplay.count());
+
+    int len = 0;
+    line[5][0] = '\0';
+    for (const auto& t : actorTypes)
+    {
+        int n = Perf().liveObjects(t.imageID);
+        if (n > 0  &&  len < static_cast<int>(sizeof(line[5])))
+            len += snprintf(line[5] + len, sizeof(line[5]) - len, "%s%s %d", (len > 0 ? "  " : ""), t.label, n);
+    }
+
+    glColor3f(1.0, 1.0, 0.0);
+    for (int k = 0; k < NUM_LINES; k++)
+        outputStroke(OVERLAY_X, OVERLAY_Y - k * OVERLAY_LINE_SPACING, SCORE_Z, OVERLAY_FONT_SIZE, line[k]);
 }
 
 void GameController::reshape (int w, int h)
 {
+    m_staticLayerVersion = -1;      // rebuild the static layer for the new window
+
     glViewport (0, 0, (GLsizei) w, (GLsizei) h);
     glMatrixMode (GL_PROJECTION);
     glLoadIdentity ();
@@ -363,53 +1142,52 @@ void GameController::reshape (int w, int h)
     glMatrixMode (GL_MODELVIEW);
 }
 
-static void doOutputStroke(double x, double y, double z, double size, const char* str, bool centered)
+static void beginStroke(double x, double y, double z, double size)
 {
-    if (centered)
-    {
-        double len = glutStrokeLength(GLUT_STROKE_ROMAN, reinterpret_cast<const unsigned char*>(str)) / FONT_SCALEDOWN;
-        x = -len / 2;
-        size = 1;
-    }
     GLfloat scaledSize = static_cast<GLfloat>(size / FONT_SCALEDOWN);
     glPushMatrix();
     glLineWidth(1);
     glLoadIdentity();
     glTranslatef(static_cast<GLfloat>(x), static_cast<GLfloat>(y), static_cast<GLfloat>(z));
     glScalef(scaledSize, scaledSize, scaledSize);
-    for ( ; *str != '\0'; str++)
-        glutStrokeCharacter(GLUT_STROKE_ROMAN, *str);
-    glPopMatrix();
 }
 
-//static void outputStroke(double x, double y, double z, double size, const char* str)
-//{
-//  doOutputStroke(x, y, z, size, str, false);
-//}
+static void outputStroke(double x, double y, double z, double size, const char* str)
+{
+    beginStroke(x, y, z, size);
+    StrokeFont::draw(str);
+    glPopMatrix();
+}
 
-static void outputStrokeCentered(double y, double z, const char* str)
+static void outputStrokeCentered(double y, double z, const StrokeLabel& label)
 {
-    doOutputStroke(0, y, z, 1, str, true);
+    beginStroke(-label.width() / FONT_SCALEDOWN / 2, y, z, 1);
+    label.draw();
+    glPopMatrix();
 }
 
-static void drawPrompt(string mainMessage, string secondMessage)
+static void drawPrompt(const StrokeLabel& mainMessage, const StrokeLabel& secondMessage)
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glColor3f (1.0, 1.0, 1.0);
     glLoadIdentity ();
-    outputStrokeCentered(1, -5, mainMessage.c_str());
-    outputStrokeCentered(-1, -5, secondMessage.c_str());
+    outputStrokeCentered(1, -5, mainMessage);
+    outputStrokeCentered(-1, -5, secondMessage);
     glutSwapBuffers();
 }
 
-static void drawScoreAndLives(string gameStatText)
+static void drawScoreAndLives(const StrokeLabel& gameStatText)
 {
     static int RATE = 1;
     static GLfloat rgb[3] =
         { static_cast<GLfloat>(.6), static_cast<GLfloat>(.6), static_cast<GLfloat>(.6) };
+      // the flicker has its own generator, since randInt belongs to the
+      // simulation thread
+    static mt19937 generator;
+    uniform_int_distribution<> flicker(-RATE, RATE);
     for (int k = 0; k < 3; k++)
     {
-        double strength = rgb[k] + randInt(-RATE, RATE) / 100.0;
+        double strength = rgb[k] + flicker(generator) / 100.0;
         if (strength < .6)
             strength = .6;
         else if (strength > 1.0)
@@ -417,5 +1195,5 @@ static void drawScoreAndLives(string gameStatText)
         rgb[k] = static_cast<GLfloat>(strength);
     }
     glColor3f(rgb[0], rgb[1], rgb[2]);
-    outputStrokeCentered(SCORE_Y, SCORE_Z, gameStatText.c_str());
+    outputStrokeCentered(SCORE_Y, SCORE_Z, gameStatText);
 }
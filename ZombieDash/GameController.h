@@ -2,41 +2,90 @@
 #define GAMECONTROLLER_H_
 
 #include "SpriteManager.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
+#include "StrokeText.h"
+#include "SpscRing.h"
+#include "RewindState.h"
+#include "GameConstants.h"
 #include <string>
 #include <map>
+#include <vector>
 #include <iostream>
 #include <sstream>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <memory>
 
 const int INVALID_KEY = 0;
 
+  // A key press, stamped when the GLUT thread got it
+struct InputEvent
+{
+    int                                   key;
+    std::chrono::steady_clock::time_point time;
+};
+
 class GraphObject;
 class GameWorld;
+class RewindBuffer;
+class GameplayRecorder;
+struct RecordedFrame;
 
 class GameController
 {
   public:
+    GameController();
+    ~GameController();
+
     void run(int argc, char* argv[], GameWorld* gw, std::string windowTitle);
 
+      // The key press taken for this tick (see takeInputEvent), if it
+      // hasn't been asked for already; simulation thread only
     bool getLastKey(int& value)
     {
-        if (m_lastKeyHit != INVALID_KEY)
+        if (m_tickInput.key == INVALID_KEY)
+            return false;
+        value = m_tickInput.key;
+        m_tickInput.key = INVALID_KEY;
+        m_tickInputUsedTime = std::chrono::steady_clock::now();
+        return true;
+    }
+
+      // Sounds asked for during a step are only noted here, once each no
+      // matter how often they're asked for, and played together when the
+      // step is done (see flushSounds).  SOUND_NONE cancels the ones asked
+      // for so far and stops whatever is playing.
+    void playSound(int soundID)
+    {
+        if (soundID == SOUND_NONE)
         {
-            value = m_lastKeyHit;
-            m_lastKeyHit = INVALID_KEY;
-            return true;
+            m_soundRequests = 0;
+            m_stopSoundsRequested = true;
         }
-        return false;
+        else if (soundID >= 0  &&  soundID < MAX_SOUND_IDS)
+            m_soundRequests |= 1u << soundID;
     }
 
-    void playSound(int soundID);
-
-    void setGameStatText(std::string text)
+    void setGameStatText(const char* text)
     {
-        m_gameStatText = text;
+          // The HUD is only recompiled when its text changes.  Assigning
+          // reuses m_gameStatText's buffer, so this doesn't allocate unless
+          // the text outgrows it.
+        if (m_gameStatText != text)
+        {
+            m_gameStatText = text;
+            m_gameStatVersion++;
+        }
     }
 
+      // One step of the game state machine; runs on the simulation thread
     void doSomething();
 
+      // Draw the latest published snapshot; runs on the GLUT thread
+    void renderFrame();
+
     void reshape(int w, int h);
     void keyboardEvent(unsigned char key, int x, int y);
     void specialKeyboardEvent(int key, int x, int y);
@@ -53,19 +102,83 @@ class GameController
 private:
     enum GameControllerState : int;
 
+    static const size_t INPUT_QUEUE_SIZE = 64;
+    static const int MAX_SOUND_IDS = 32;    // one bit each in m_soundRequests
+
+      // What to play for a sound ID; clip is -1 if there's nothing
+    struct SoundClip
+    {
+        int clip;
+        int priority;   // higher plays first and cuts off lower
+    };
+
     GameWorld*          m_gw;
     GameControllerState m_gameState;
     GameControllerState m_nextStateAfterPrompt;
     GameControllerState m_nextStateAfterAnimate;
-    int         m_lastKeyHit;
-    bool        m_singleStep;
+    std::atomic<bool> m_singleStep;
+    std::atomic<int>  m_fastForward;        // ticks per frame, FAST_FORWARD_MAX, or 1 for real time
+    std::atomic<bool> m_quitRequested;
+    std::atomic<bool> m_simulationFinished;
+    bool        m_showPerfOverlay;      // touched only by the GLUT thread
     std::string m_gameStatText;
+    long long   m_gameStatVersion;      // counts changes to m_gameStatText
     std::string m_mainMessage;
     std::string m_secondMessage;
-    int         m_curIntraFrameTick;
-    using SoundMapType = std::map<int, std::string>;
+    double      m_tickAccumulatorMs;    // real time not yet simulated
+
+      // The world after each tick of this life on this level, which can be
+      // stepped through in single-step mode (simulation thread only)
+    std::unique_ptr<RewindBuffer> m_rewind;
+    RewindState  m_rewindState;         // scratch
+    long long    m_rewindTick;          // the tick the world is at
+
+    std::chrono::steady_clock::time_point m_lastUpdateTime;
+    std::chrono::steady_clock::time_point m_animateStartTime;
+    std::chrono::steady_clock::time_point m_lastBatchTime;    // fast-forward only
+
+      // Key presses queue up here in the GLUT callbacks until the
+      // simulation thread takes them, one per tick, into m_tickInput
+    SpscRing<InputEvent, INPUT_QUEUE_SIZE> m_inputEvents;
+    InputEvent                             m_tickInput;   // key is INVALID_KEY once used
+    std::chrono::steady_clock::time_point  m_tickInputUsedTime;
+
+      // The last key press a tick used, until the render thread has drawn
+      // a snapshot from that tick or later (simulation thread only)
+    InputStamp  m_pendingInput;
+    long long   m_pendingInputSequence;     // the first snapshot it went out in
+    long long   m_inputsUsed;
+    long long   m_lastInputDisplayed;       // GLUT thread only
+
+      // The simulation thread publishes a snapshot after every tick (and on
+      // each prompt); the GLUT thread draws whichever one is newest.
+    std::thread                    m_simulationThread;
+    TripleBuffer<RenderSnapshot>   m_snapshots;
+    long long                      m_publishedSequence;   // simulation thread only
+    std::atomic<long long>         m_presentedSequence;
+    std::vector<int>               m_framesPerImage;      // read-only once running
+    long long                      m_staticLayerVersion;      // GLUT thread only; -1 to rebuild
+    bool                           m_assetLoadFailed;         // GLUT thread only
+
+      // Text drawn every frame, recompiled when it changes (GLUT thread only)
+    StrokeLabel m_hudLabel;
+    long long   m_hudLabelVersion;      // m_gameStatVersion it shows
+    StrokeLabel m_mainMessageLabel;
+    StrokeLabel m_secondMessageLabel;
+
+      // The camera and the static region it is in (simulation thread only)
+    double      m_cameraX;
+    double      m_cameraY;
+    double      m_staticRegion[4];      // min x, min y, max x, max y
+    long long   m_staticRegionVersion;
+    long long   m_staticRegionGeneration;   // GraphObject::staticGeneration() when filled
     using DrawMapType =  std::map<int, std::string>;
-    SoundMapType  m_soundMap;
+    SoundClip     m_soundClips[MAX_SOUND_IDS];
+    unsigned int  m_soundRequests;          // bit n: sound ID n asked for this step
+    bool          m_stopSoundsRequested;    // simulation thread only, as are these
+    std::string   m_audioOutputFile;    // record the audio here instead of playing it
+    std::string   m_playbackFile;       // show this recording instead of playing
+    std::unique_ptr<GameplayRecorder> m_recorder;   // what is shown, if --record was given
     bool          m_playerWon;
     SpriteManager m_spriteManager;
 
@@ -74,7 +187,22 @@ private:
                             std::string mainMessage, std::string secondMessage);
 
     void initDrawersAndSounds();
-    void displayGamePlay();
+    void simulationLoop();
+    void playbackLoop();
+    void publishRecordedFrame(const RecordedFrame& frame);
+    void postInputEvent(int key);
+    void takeInputEvent();
+    void runTick(bool shown = true);
+    void runFastForwardBatch(int ticks);
+    void recordRewindState();
+    void seekRewind(long long tick);
+    void flushSounds();
+    void updateCamera(double& fromX, double& fromY);
+    void publishGameplaySnapshot(bool interpolate);
+    void stampInput(RenderSnapshot& snapshot);
+    void publishPromptSnapshot();
+    void displayGamePlay(const RenderSnapshot& snapshot);
+    void drawPerfOverlay();
 };
 
 inline GameController& Game()
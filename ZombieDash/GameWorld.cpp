@@ -4,8 +4,14 @@
 #include <cstdlib>
 using namespace std;
 
+  // A world with no controller runs headless (e.g., under the benchmark):
+  // there is never a key, and sounds and status text go nowhere.
+
 bool GameWorld::getKey(int& value)
 {
+    if (m_controller == nullptr)
+        return false;
+
     bool gotKey = m_controller->getLastKey(value);
 
     if (gotKey)
@@ -18,10 +24,17 @@ bool GameWorld::getKey(int& value)
 
 void GameWorld::playSound(int soundID)
 {
-    m_controller->playSound(soundID);
+    if (m_controller != nullptr)
+        m_controller->playSound(soundID);
 }
 
 void GameWorld::setGameStatText(string text)
 {
-    m_controller->setGameStatText(text);
+    setGameStatText(text.c_str());
+}
+
+void GameWorld::setGameStatText(const char* text)
+{
+    if (m_controller != nullptr)
+        m_controller->setGameStatText(text);
 }
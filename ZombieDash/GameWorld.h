@@ -2,6 +2,8 @@
 #define GAMEWORLD_H_
 
 #include "GameConstants.h"
+#include "GraphObject.h"
+#include "RewindState.h"
 #include <string>
 
 const int START_PLAYER_LIVES = 3;
@@ -14,7 +16,7 @@ public:
 
     GameWorld(std::string assetPath)
      : m_lives(START_PLAYER_LIVES), m_score(0), m_level(1),
-       m_controller(nullptr), m_assetPath(assetPath)
+       m_controller(nullptr), m_assetPath(assetPath), m_tickShown(true)
     {
     }
 
@@ -26,7 +28,23 @@ public:
     virtual int move() = 0;
     virtual void cleanUp() = 0;
 
+      // The point the camera should keep centered, and the size of the
+      // world, both in GraphObject coordinates.  By default the world is
+      // exactly one view, so the camera never moves.
+    virtual void getCameraFocus(double& x, double& y) const
+    {
+        x = VIEW_WIDTH / 2;
+        y = VIEW_HEIGHT / 2;
+    }
+
+    virtual void getWorldSize(double& width, double& height) const
+    {
+        width = VIEW_WIDTH;
+        height = VIEW_HEIGHT;
+    }
+
     void setGameStatText(std::string text);
+    void setGameStatText(const char* text);
 
     bool getKey(int& value);
     void playSound(int soundID);
@@ -65,6 +83,14 @@ public:
     {
         return m_assetPath;
     }
+
+      // False during a fast-forwarded tick that won't be drawn, so move()
+      // can skip work that only matters to the display, e.g., the status
+      // text
+    bool isTickShown() const
+    {
+        return m_tickShown;
+    }
     
       // The following should be used by only the framework, not the student
 
@@ -82,6 +108,47 @@ public:
     {
         m_controller = controller;
     }
+
+    void setTickShown(bool shown)
+    {
+        m_tickShown = shown;
+    }
+
+      // Every GraphObject in this world
+    SceneRegistry& scene()
+    {
+        return m_scene;
+    }
+
+      // Fill in state with what it takes to put the world back the way it
+      // is now (except state.tick), or put it back that way.  The score is
+      // handled here and the rest by the world; false if it can't.
+    bool saveState(RewindState& state) const
+    {
+        state.score = m_score;
+        return saveWorldState(state);
+    }
+
+    bool restoreState(const RewindState& state)
+    {
+        int score = m_score;
+        m_score = state.score;
+        if (restoreWorldState(state))
+            return true;
+        m_score = score;
+        return false;
+    }
+
+protected:
+    virtual bool saveWorldState(RewindState& /* state */) const
+    {
+        return false;
+    }
+
+    virtual bool restoreWorldState(const RewindState& /* state */)
+    {
+        return false;
+    }
     
 private:
     int m_lives;
@@ -89,6 +156,8 @@ private:
     int m_level;
     GameController* m_controller;
     std::string     m_assetPath;
+    SceneRegistry   m_scene;
+    bool            m_tickShown;
 };
 
 #endif // GAMEWORLD_H_
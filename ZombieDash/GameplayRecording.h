@@ -0,0 +1,467 @@
+#ifndef GAMEPLAYRECORDING_H_
+#define GAMEPLAYRECORDING_H_
+
+#include "RenderSnapshot.h"
+#include "RewindBuffer.h"
+#include "SpscRing.h"
+#include "AssetPack.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+  // A recording of what the game showed, frame by frame: for each gameplay
+  // snapshot published, the sprites it drew, where the camera was, and the
+  // HUD text.  Playing it back needs no simulation at all, so it shows the
+  // same thing however the game's code has changed since.
+  //
+  // The file starts with magic() and a format version (a varint), and then
+  // has blocks of KEYFRAME_INTERVAL frames (the last may have fewer), each
+  // the number of frames, the size of its data as written and as stored
+  // (varints), and the data, compressed with AssetCompression.  The data
+  // is a record per frame: the HUD text's length + 1 and the text, or 0
+  // if it's the same as the last frame's, then the frame as a RewindCoder
+  // writes a RewindState, a keyframe for a block's first frame and then
+  // deltas.  In that state each sprite is an object whose ID is its
+  // serial, whose kind is its image ID, and whose values are its animation
+  // frame, depth, size and whether it's static; the camera position is in
+  // world values 0 and 1.  Positions are in 1/POSITION_SCALE of a pixel.
+
+struct RecordedFrame
+{
+    RecordedFrame()
+     : cameraX(0), cameraY(0), staticVersion(-1)
+    {}
+
+    double                      cameraX;
+    double                      cameraY;
+    std::string                 hudText;
+    std::vector<SpriteInstance> sprites;            // in drawing order on playback
+    std::vector<SpriteInstance> staticSprites;
+    long long                   staticVersion;      // playback only: changes when staticSprites do
+};
+
+class RecordingFormat
+{
+  public:
+    static const int VERSION = 1;
+    static const int KEYFRAME_INTERVAL = 256;
+    static const int POSITION_SCALE = 16;
+    static const int SIZE_SCALE = 256;
+    static const std::uint32_t MAX_BLOCK_SIZE = 64 << 20;  // far above KEYFRAME_INTERVAL frames of any level
+
+    static const char* magic()
+    {
+        return "ZDRC";
+    }
+
+      // state's objects in increasing ID order, as a RewindCoder needs them
+    static void toState(const RecordedFrame& f, RewindState& state)
+    {
+        state.score = 0;
+        for (int& v : state.worldValues)
+            v = 0;
+        state.worldValues[0] = scaled(f.cameraX, POSITION_SCALE);
+        state.worldValues[1] = scaled(f.cameraY, POSITION_SCALE);
+        state.objects.clear();
+        for (const SpriteInstance& s : f.staticSprites)
+            state.objects.push_back(toObject(s, true));
+        for (const SpriteInstance& s : f.sprites)
+            state.objects.push_back(toObject(s, false));
+        std::sort(state.objects.begin(), state.objects.end(),
+                  [](const RewindObject& a, const RewindObject& b) { return a.id < b.id; });
+    }
+
+      // The sprites in drawing order: back to front, then by serial
+    static void fromState(const RewindState& state, RecordedFrame& f, std::vector<SpriteInstance>& statics)
+    {
+        f.cameraX = static_cast<double>(state.worldValues[0]) / POSITION_SCALE;
+        f.cameraY = static_cast<double>(state.worldValues[1]) / POSITION_SCALE;
+        f.sprites.clear();
+        statics.clear();
+        for (const RewindObject& o : state.objects)
+            (o.values[3] ? statics : f.sprites).push_back(fromObject(o));
+        auto drawingOrder = [](const SpriteInstance& a, const SpriteInstance& b)
+        {
+            if (a.depth != b.depth)
+                return a.depth > b.depth;
+            return a.serial < b.serial;
+        };
+        std::sort(f.sprites.begin(), f.sprites.end(), drawingOrder);
+        std::sort(statics.begin(), statics.end(), drawingOrder);
+    }
+
+  private:
+    static int scaled(double v, int scale)
+    {
+        return static_cast<int>(std::lround(v * scale));
+    }
+
+    static RewindObject toObject(const SpriteInstance& s, bool isStatic)
+    {
+        RewindObject o;
+        o.id = static_cast<unsigned int>(s.serial);
+        o.kind = s.imageID;
+        o.x = scaled(s.x, POSITION_SCALE);
+        o.y = scaled(s.y, POSITION_SCALE);
+        o.direction = s.direction;
+        for (int& v : o.values)
+            v = 0;
+        o.values[0] = s.frame;
+        o.values[1] = s.depth;
+        o.values[2] = scaled(s.size, SIZE_SCALE);
+        o.values[3] = isStatic;
+        return o;
+    }
+
+    static SpriteInstance fromObject(const RewindObject& o)
+    {
+        SpriteInstance s;
+        s.imageID = o.kind;
+        s.frame = o.values[0];
+        s.x = s.fromX = static_cast<double>(o.x) / POSITION_SCALE;
+        s.y = s.fromY = static_cast<double>(o.y) / POSITION_SCALE;
+        s.direction = o.direction;
+        s.size = static_cast<double>(o.values[2]) / SIZE_SCALE;
+        s.depth = o.values[1];
+        s.serial = o.id;
+        return s;
+    }
+};
+
+  // How long the recording writer sleeps when there's no frame to write
+static const int RECORDING_WRITER_IDLE_MS = 5;
+
+  // Writes a recording on a thread of its own.  addFrame() only copies the
+  // snapshot into one of a fixed set of frames and queues it, so recording
+  // never holds up a tick; once the frames' vectors have grown to fit, it
+  // doesn't allocate either.  If the writer falls so far behind that
+  // every frame is waiting for it, the new one is dropped and counted.
+class GameplayRecorder
+{
+  public:
+    static const int NUM_FRAMES = 64;
+
+    GameplayRecorder()
+     : m_stopRequested(false), m_droppedFrames(0), m_numFrames(0)
+    {}
+
+    ~GameplayRecorder()
+    {
+        stop();
+    }
+
+      // Begin a recording in filename; false if it can't be created
+    bool start(const std::string& filename)
+    {
+        stop();
+        m_file.open(filename, std::ios::out|std::ios::binary|std::ios::trunc);
+        if (!m_file)
+            return false;
+        const char* magic = RecordingFormat::magic();
+        std::vector<char> header(magic, magic + std::strlen(magic));
+        RewindCoder::putVarint(header, RecordingFormat::VERSION);
+        m_file.write(header.data(), header.size());
+
+        int slot;
+        while (m_freeFrames.pop(slot))
+            ;
+        while (m_queuedFrames.pop(slot))
+            ;
+        for (int k = 0; k < NUM_FRAMES; k++)
+            m_freeFrames.push(k);
+        m_stopRequested = false;
+        m_droppedFrames = 0;
+        m_numFrames = 0;
+        m_block.clear();
+        m_blockFrames = 0;
+        m_thread = std::thread(&GameplayRecorder::run, this);
+        return true;
+    }
+
+      // Write whatever is queued and finish the file
+    void stop()
+    {
+        if (!m_thread.joinable())
+            return;
+        m_stopRequested = true;
+        m_thread.join();
+        m_file.close();
+    }
+
+    bool isRecording() const
+    {
+        return m_thread.joinable();
+    }
+
+    long long numFrames() const
+    {
+        return m_numFrames.load(std::memory_order_relaxed);
+    }
+
+    long long droppedFrames() const
+    {
+        return m_droppedFrames.load(std::memory_order_relaxed);
+    }
+
+      // Call only from the thread that publishes the snapshots
+    void addFrame(const RenderSnapshot& snapshot)
+    {
+        int slot;
+        if (!m_freeFrames.pop(slot))
+        {
+            m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        RecordedFrame& f = m_frames[slot];
+        f.cameraX = snapshot.cameraX;
+        f.cameraY = snapshot.cameraY;
+        f.hudText = snapshot.hudText;
+        f.sprites = snapshot.sprites;
+        f.staticSprites = snapshot.staticSprites;
+        m_queuedFrames.push(slot);      // there's always room for every frame
+    }
+
+    GameplayRecorder(const GameplayRecorder&) = delete;
+    GameplayRecorder& operator=(const GameplayRecorder&) = delete;
+
+  private:
+    RecordedFrame               m_frames[NUM_FRAMES];
+    SpscRing<int, NUM_FRAMES>   m_freeFrames;       // from the writer thread to addFrame()
+    SpscRing<int, NUM_FRAMES>   m_queuedFrames;     // from addFrame() to the writer thread
+    std::thread                 m_thread;
+    std::atomic<bool>           m_stopRequested;
+    std::atomic<long long>      m_droppedFrames;
+    std::atomic<long long>      m_numFrames;        // written so far
+
+      // Touched only by the writer thread while it runs
+    std::ofstream     m_file;
+    RewindCoder       m_coder;
+    RewindState       m_state;
+    std::vector<char> m_block;
+    int               m_blockFrames;
+    std::string       m_lastHudText;
+
+    void run()
+    {
+        for (;;)
+        {
+            bool stopping = m_stopRequested;
+            int slot;
+            while (m_queuedFrames.pop(slot))
+            {
+                writeFrame(m_frames[slot]);
+                m_freeFrames.push(slot);
+            }
+            if (stopping)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(RECORDING_WRITER_IDLE_MS));
+        }
+        writeBlock();
+    }
+
+    void writeFrame(const RecordedFrame& f)
+    {
+        if (m_blockFrames == 0  ||  f.hudText != m_lastHudText)
+        {
+            RewindCoder::putVarint(m_block, static_cast<std::uint32_t>(f.hudText.size() + 1));
+            m_block.insert(m_block.end(), f.hudText.begin(), f.hudText.end());
+            m_lastHudText = f.hudText;
+        }
+        else
+            RewindCoder::putVarint(m_block, 0);
+
+        RecordingFormat::toState(f, m_state);
+        if (m_blockFrames == 0)
+            m_coder.writeKeyframe(m_block, m_state);
+        else
+            m_coder.writeDelta(m_block, m_state);
+        m_numFrames.fetch_add(1, std::memory_order_relaxed);
+        if (++m_blockFrames == RecordingFormat::KEYFRAME_INTERVAL)
+            writeBlock();
+    }
+
+      // Each block is flushed as it is finished, so a recording cut short
+      // loses at most the block it was in the middle of
+    void writeBlock()
+    {
+        if (m_blockFrames == 0)
+            return;
+        std::vector<char> stored = AssetCompression::compress(m_block.data(), m_block.size());
+        std::vector<char> header;
+        RewindCoder::putVarint(header, static_cast<std::uint32_t>(m_blockFrames));
+        RewindCoder::putVarint(header, static_cast<std::uint32_t>(m_block.size()));
+        RewindCoder::putVarint(header, static_cast<std::uint32_t>(stored.size()));
+        m_file.write(header.data(), header.size());
+        m_file.write(stored.data(), stored.size());
+        m_file.flush();
+        m_block.clear();
+        m_blockFrames = 0;
+    }
+};
+
+  // Reads a recording for playback.  The whole file is read at once, but
+  // only the block being shown is decoded, so seeking anywhere in a long
+  // recording costs at most decoding KEYFRAME_INTERVAL frames, and playing
+  // forward costs one frame at a time.
+class GameplayPlayback
+{
+  public:
+    GameplayPlayback()
+     : m_numFrames(0), m_staticVersion(0), m_decodedBlock(-1), m_decodedFrame(-1)
+    {}
+
+      // False if filename isn't a recording.  A block cut short at the end
+      // of the file (e.g. because the game crashed) is left out, as is one
+      // whose header is damaged, along with everything after it.
+    bool open(const std::string& filename)
+    {
+        m_blocks.clear();
+        m_numFrames = 0;
+        m_decodedBlock = -1;
+        if (!Assets().read(filename, m_file))
+            return false;
+        const char* p = m_file.data();
+        const char* end = p + m_file.size();
+        size_t magicSize = std::strlen(RecordingFormat::magic());
+        std::uint32_t version;
+        if (m_file.size() < magicSize  ||  std::memcmp(p, RecordingFormat::magic(), magicSize) != 0)
+            return false;
+        p += magicSize;
+        if (!RewindCoder::getVarint(p, end, version)  ||  version != RecordingFormat::VERSION)
+            return false;
+
+        while (p != end)
+        {
+            Block b;
+            std::uint32_t numFrames, rawSize, storedSize;
+            if (!RewindCoder::getVarint(p, end, numFrames)  ||  !RewindCoder::getVarint(p, end, rawSize)  ||
+                !RewindCoder::getVarint(p, end, storedSize)  ||  storedSize > static_cast<size_t>(end - p)  ||
+                numFrames == 0  ||  numFrames > RecordingFormat::KEYFRAME_INTERVAL  ||
+                rawSize > RecordingFormat::MAX_BLOCK_SIZE  ||  rawSize > AssetCompression::maxDecompressedSize(storedSize))
+                break;
+            b.firstFrame = m_numFrames;
+            b.numFrames = numFrames;
+            b.data = p;
+            b.rawSize = rawSize;
+            b.storedSize = storedSize;
+            m_blocks.push_back(b);
+            m_numFrames += numFrames;
+            p += storedSize;
+            if (numFrames < RecordingFormat::KEYFRAME_INTERVAL)
+                break;      // only the last block is short
+        }
+        return true;
+    }
+
+    long long numFrames() const
+    {
+        return m_numFrames;
+    }
+
+      // Put frame into f, which should be the RecordedFrame passed last
+      // time (its static sprites are only replaced when they change); false
+      // if there's no such frame or the recording is damaged
+    bool seek(long long frame, RecordedFrame& f)
+    {
+        if (frame < 0  ||  frame >= m_numFrames)
+            return false;
+        long long k = frame / RecordingFormat::KEYFRAME_INTERVAL;
+        if (k != m_decodedBlock  ||  frame < m_decodedFrame)
+        {
+            const Block& b = m_blocks[static_cast<size_t>(k)];
+            m_raw.resize(b.rawSize);
+            m_decodedBlock = -1;
+            if (!AssetCompression::decompress(b.data, b.storedSize, m_raw.data(), m_raw.size()))
+                return false;
+            m_next = m_raw.data();
+            if (!readFrame(true))
+                return false;
+            m_decodedBlock = k;
+            m_decodedFrame = b.firstFrame;
+        }
+        while (m_decodedFrame < frame)
+        {
+            if (!readFrame(false))
+            {
+                m_decodedBlock = -1;
+                return false;
+            }
+            m_decodedFrame++;
+        }
+
+        m_coder.getState(m_state);
+        RecordingFormat::fromState(m_state, f, m_statics);
+        f.hudText = m_hudText;
+        if (!sameSprites(m_statics, f.staticSprites))
+        {
+            f.staticSprites.swap(m_statics);
+            f.staticVersion = ++m_staticVersion;
+        }
+        return true;
+    }
+
+    GameplayPlayback(const GameplayPlayback&) = delete;
+    GameplayPlayback& operator=(const GameplayPlayback&) = delete;
+
+  private:
+    struct Block
+    {
+        long long   firstFrame;
+        int         numFrames;
+        const char* data;
+        size_t      rawSize;
+        size_t      storedSize;
+    };
+
+    AssetData                   m_file;
+    std::vector<Block>          m_blocks;
+    long long                   m_numFrames;
+    long long                   m_staticVersion;
+
+      // The block being played and how far into it decoding has got
+    long long                   m_decodedBlock;     // -1 if none
+    long long                   m_decodedFrame;
+    std::vector<char>           m_raw;
+    const char*                 m_next;             // the next frame's record in m_raw
+    RewindCoder                 m_coder;
+    RewindState                 m_state;
+    std::string                 m_hudText;
+    std::vector<SpriteInstance> m_statics;          // scratch
+
+    bool readFrame(bool keyframe)
+    {
+        const char* end = m_raw.data() + m_raw.size();
+        std::uint32_t hudSize;
+        if (!RewindCoder::getVarint(m_next, end, hudSize)  ||  hudSize > static_cast<size_t>(end - m_next) + 1)
+            return false;
+        if (hudSize > 0)
+        {
+            m_hudText.assign(m_next, hudSize - 1);
+            m_next += hudSize - 1;
+        }
+        return keyframe ? m_coder.readKeyframe(m_next, end) : m_coder.readDelta(m_next, end);
+    }
+
+    static bool sameSprites(const std::vector<SpriteInstance>& a, const std::vector<SpriteInstance>& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t k = 0; k < a.size(); k++)
+        {
+            if (a[k].serial != b[k].serial  ||  a[k].imageID != b[k].imageID  ||  a[k].frame != b[k].frame  ||
+                a[k].x != b[k].x  ||  a[k].y != b[k].y  ||  a[k].direction != b[k].direction  ||
+                a[k].size != b[k].size  ||  a[k].depth != b[k].depth)
+                return false;
+        }
+        return true;
+    }
+};
+
+#endif // GAMEPLAYRECORDING_H_
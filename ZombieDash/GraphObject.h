@@ -3,14 +3,16 @@
 
 #include "SpriteManager.h"
 #include "GameConstants.h"
+#include "PerfCounters.h"
 
-#include <set>
+#include <vector>
+#include <algorithm>
 #include <cmath>
 
-const int ANIMATION_POSITIONS_PER_TICK = 1;
-
 using Direction = int;
 
+class SceneRegistry;
+
 class GraphObject
 {
   public:
@@ -20,20 +22,8 @@ class GraphObject
     static const int up = 90;
     static const int down = 270;
 
-    GraphObject(int imageID, double startX, double startY, Direction dir = 0, int depth = 0, double size = 1.0)
-     : m_imageID(imageID), m_x(startX), m_y(startY), m_destX(startX), m_destY(startY),
-       m_animationNumber(0), m_direction(dir), m_depth(depth), m_size(size)
-    {
-        if (m_size <= 0)
-            m_size = 1;
-
-        getGraphObjects(m_depth).insert(this);
-    }
-
-    virtual ~GraphObject()
-    {
-        getGraphObjects(m_depth).erase(this);
-    }
+    GraphObject(SceneRegistry& scene, int imageID, double startX, double startY, Direction dir = 0, int depth = 0, double size = 1.0);
+    virtual ~GraphObject();
 
     double getX() const
     {
@@ -47,12 +37,7 @@ class GraphObject
         return m_destY;
     }
 
-    virtual void moveTo(double x, double y)
-    {
-        m_destX = x;
-        m_destY = y;
-        increaseAnimationNumber();
-    }
+    virtual void moveTo(double x, double y);
 
     Direction getDirection() const
     {
@@ -84,17 +69,15 @@ class GraphObject
         m_animationNumber++;
     }
 
-    template<typename Func>
-    static void drawAllObjects(Func plotFunc)
+      // Objects created with a static image ID never move, so the renderer
+      // may draw them once into a cached layer.  Declare these before
+      // creating any objects.
+    static void setStaticImage(int imageID)
     {
-        for (int depth = NUM_DEPTHS - 1; depth >= 0; depth--)
-        {
-            for (GraphObject* go : getGraphObjects(depth))
-            {
-                go->animate();
-                plotFunc(go->m_imageID, go->m_animationNumber, go->m_x, go->m_y, go->m_direction, go->m_size);
-            }
-        }
+        std::vector<bool>& images = staticImages();
+        if (imageID >= static_cast<int>(images.size()))
+            images.resize(imageID + 1, false);
+        images[imageID] = true;
     }
 
       // Prevent copying or assigning GraphObjects
@@ -102,45 +85,274 @@ class GraphObject
     GraphObject& operator=(const GraphObject&) = delete;
 
   private:
+    friend class SceneRegistry;
 
     static const int NUM_DEPTHS = 4;
+    SceneRegistry* m_scene;
     int     m_imageID;
-    double  m_x;
-    double  m_y;
+    double  m_prevX;
+    double  m_prevY;
     double  m_destX;
     double  m_destY;
+    long long m_moveTick;       // tick in which the object last moved
     int     m_animationNumber;
     Direction   m_direction;
     int     m_depth;
     double  m_size;
+    bool    m_static;
+
+      // Bookkeeping owned by m_scene
+    long long m_serial;         // creation order, for a deterministic drawing order
+    size_t  m_sceneIndex;       // index in the scene's object list
+    int     m_cellX;            // spatial grid cell containing (m_destX, m_destY)
+    int     m_cellY;
+    size_t  m_gridSlot;         // index in that cell's bucket
+
+    int drawDepth() const
+    {
+        return (m_depth >= 0  &&  m_depth < NUM_DEPTHS ? m_depth : 0);
+    }
 
-    void animate()
+    void positionBeforeTick(long long currentTick, double& x, double& y) const
     {
-        m_x = m_destX;
-        m_y = m_destY;
-        //moveALittle(m_x, m_destX);
-        //moveALittle(m_y, m_destY);
+          // Objects that didn't move during the latest tick stay where they are
+        if (m_moveTick != currentTick)
+        {
+            x = m_destX;
+            y = m_destY;
+            return;
+        }
+        x = m_prevX;
+        y = m_prevY;
     }
 
-    void moveALittle(double& from, double& to)
+    static std::vector<bool>& staticImages()
     {
-        static const double DISTANCE = 1.0/ANIMATION_POSITIONS_PER_TICK;
-        if (to - from >= DISTANCE)
-            from += DISTANCE;
-        else if (from - to >= DISTANCE)
-            from -= DISTANCE;
-        else
-            from = to;
+        static std::vector<bool> images;
+        return images;
     }
 
-    static std::set<GraphObject*>& getGraphObjects(int depth)
+    static bool isStaticImage(int imageID)
     {
-        static std::set<GraphObject*> graphObjects[NUM_DEPTHS];
-        if (depth < NUM_DEPTHS)
-            return graphObjects[depth];
-        else
-            return graphObjects[0];     // empty;
+        const std::vector<bool>& images = staticImages();
+        return imageID >= 0  &&  imageID < static_cast<int>(images.size())  &&  images[imageID];
     }
 };
 
+  // Every GraphObject in one world.  The world owns its registry, and each
+  // object records where it is filed, so adding, removing, and moving an
+  // object are constant time and never allocate once the registry's
+  // vectors have grown to fit the level.
+  //
+  // Objects are also filed in an unbounded spatial grid of GRID_CELL_SIZE
+  // squares by position, so drawing can visit only those near the view.
+  // Cells hash into GRID_BUCKETS buckets; a bucket may hold objects from
+  // several cells.
+class SceneRegistry
+{
+  public:
+
+    SceneRegistry()
+     : m_nextSerial(0), m_tick(0), m_staticGeneration(0)
+    {}
+
+    int size() const
+    {
+        return static_cast<int>(m_objects.size());
+    }
+
+      // Call once at the start of each simulation tick
+    void advanceTick()
+    {
+        m_tick++;
+    }
+
+    long long currentTick() const
+    {
+        return m_tick;
+    }
+
+      // Changes whenever a static object is created or destroyed
+    long long staticGeneration() const
+    {
+        return m_staticGeneration;
+    }
+
+      // Hand every object that can move and is within the given rectangle
+      // (plus a sprite or two of margin) to plotFunc in drawing order, with
+      // where it was before the latest tick and where that tick left it, so
+      // the renderer can interpolate between the two, and a serial number
+      // that tells it apart from every other object.  Objects elsewhere in
+      // the world aren't visited at all.
+    template<typename Func>
+    void drawDynamicObjects(double minX, double minY, double maxX, double maxY, Func plotFunc)
+    {
+        drawObjects(false, minX, minY, maxX, maxY, plotFunc);
+    }
+
+      // Same, for the static objects only
+    template<typename Func>
+    void drawStaticObjects(double minX, double minY, double maxX, double maxY, Func plotFunc)
+    {
+        drawObjects(true, minX, minY, maxX, maxY, plotFunc);
+    }
+
+    SceneRegistry(const SceneRegistry&) = delete;
+    SceneRegistry& operator=(const SceneRegistry&) = delete;
+
+  private:
+    friend class GraphObject;
+
+    static const int GRID_CELL_SIZE = 4 * SPRITE_WIDTH;
+    static const int GRID_BUCKETS = 4096;
+    static const int CULL_MARGIN = 2 * SPRITE_WIDTH;    // sprites are drawn up and right of their position
+
+    std::vector<GraphObject*> m_objects;
+    std::vector<GraphObject*> m_buckets[GRID_BUCKETS];
+    std::vector<GraphObject*> m_visible;    // reused by drawObjects
+    long long m_nextSerial;
+    long long m_tick;
+    long long m_staticGeneration;
+
+    void add(GraphObject* go)
+    {
+        go->m_serial = m_nextSerial++;
+        go->m_sceneIndex = m_objects.size();
+        m_objects.push_back(go);
+        go->m_cellX = cellOf(go->m_destX);
+        go->m_cellY = cellOf(go->m_destY);
+        gridInsert(go);
+        if (go->m_static)
+            m_staticGeneration++;
+    }
+
+    void remove(GraphObject* go)
+    {
+          // Move the last object into the vacated slot
+        GraphObject* last = m_objects.back();
+        m_objects[go->m_sceneIndex] = last;
+        last->m_sceneIndex = go->m_sceneIndex;
+        m_objects.pop_back();
+        gridRemove(go);
+        if (go->m_static)
+            m_staticGeneration++;
+    }
+
+    void moved(GraphObject* go)
+    {
+        int cellX = cellOf(go->m_destX);
+        int cellY = cellOf(go->m_destY);
+        if (cellX != go->m_cellX  ||  cellY != go->m_cellY)
+        {
+            gridRemove(go);
+            go->m_cellX = cellX;
+            go->m_cellY = cellY;
+            gridInsert(go);
+        }
+    }
+
+    template<typename Func>
+    void drawObjects(bool statics, double minX, double minY, double maxX, double maxY, Func plotFunc)
+    {
+        minX -= CULL_MARGIN;
+        minY -= CULL_MARGIN;
+        maxX += CULL_MARGIN;
+        maxY += CULL_MARGIN;
+
+        m_visible.clear();
+        for (int cellY = cellOf(minY); cellY <= cellOf(maxY); cellY++)
+        {
+            for (int cellX = cellOf(minX); cellX <= cellOf(maxX); cellX++)
+            {
+                for (GraphObject* go : m_buckets[bucketOf(cellX, cellY)])
+                {
+                    if (go->m_cellX == cellX  &&  go->m_cellY == cellY  &&  go->m_static == statics  &&
+                        go->m_destX >= minX  &&  go->m_destX <= maxX  &&
+                        go->m_destY >= minY  &&  go->m_destY <= maxY)
+                        m_visible.push_back(go);
+                }
+            }
+        }
+
+          // Back to front, then in order of creation
+        std::sort(m_visible.begin(), m_visible.end(),
+            [](const GraphObject* a, const GraphObject* b)
+            {
+                if (a->drawDepth() != b->drawDepth())
+                    return a->drawDepth() > b->drawDepth();
+                return a->m_serial < b->m_serial;
+            });
+
+        for (GraphObject* go : m_visible)
+        {
+            double fromX, fromY;
+            go->positionBeforeTick(m_tick, fromX, fromY);
+            plotFunc(go->m_imageID, go->m_animationNumber, fromX, fromY, go->m_destX, go->m_destY,
+                     go->m_direction, go->m_size, go->drawDepth(), go->m_serial);
+        }
+    }
+
+    static int cellOf(double coord)
+    {
+        return static_cast<int>(std::floor(coord / GRID_CELL_SIZE));
+    }
+
+    static int bucketOf(int cellX, int cellY)
+    {
+        unsigned int h = static_cast<unsigned int>(cellX) * 73856093u ^ static_cast<unsigned int>(cellY) * 19349663u;
+        return static_cast<int>(h % GRID_BUCKETS);
+    }
+
+    void gridInsert(GraphObject* go)
+    {
+        std::vector<GraphObject*>& bucket = m_buckets[bucketOf(go->m_cellX, go->m_cellY)];
+        go->m_gridSlot = bucket.size();
+        bucket.push_back(go);
+    }
+
+    void gridRemove(GraphObject* go)
+    {
+          // Move the bucket's last object into the vacated slot
+        std::vector<GraphObject*>& bucket = m_buckets[bucketOf(go->m_cellX, go->m_cellY)];
+        GraphObject* last = bucket.back();
+        bucket[go->m_gridSlot] = last;
+        last->m_gridSlot = go->m_gridSlot;
+        bucket.pop_back();
+    }
+};
+
+inline GraphObject::GraphObject(SceneRegistry& scene, int imageID, double startX, double startY, Direction dir, int depth, double size)
+ : m_scene(&scene), m_imageID(imageID), m_prevX(startX), m_prevY(startY), m_destX(startX), m_destY(startY),
+   m_moveTick(-1), m_animationNumber(0), m_direction(dir), m_depth(depth), m_size(size),
+   m_static(isStaticImage(imageID))
+{
+    if (m_size <= 0)
+        m_size = 1;
+
+    m_scene->add(this);
+    Perf().objectCreated(m_imageID);
+}
+
+inline GraphObject::~GraphObject()
+{
+    m_scene->remove(this);
+    Perf().objectDestroyed(m_imageID);
+}
+
+inline void GraphObject::moveTo(double x, double y)
+{
+      // Remember where this tick's movement started so drawing can
+      // interpolate from there
+    if (m_moveTick != m_scene->currentTick())
+    {
+        m_prevX = m_destX;
+        m_prevY = m_destY;
+        m_moveTick = m_scene->currentTick();
+    }
+    m_destX = x;
+    m_destY = y;
+    m_scene->moved(this);
+    increaseAnimationNumber();
+}
+
 #endif // GRAPHOBJ_H_
@@ -2,9 +2,12 @@
 #define LEVEL_H_
 
 #include "GameConstants.h"
+#include "AssetPack.h"
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <sstream>
 #include <cctype>
 
 class Level
@@ -20,60 +23,209 @@ public:
         load_success, load_fail_file_not_found, load_fail_bad_format
     };
 
+    enum SaveFormat {
+        text_format, binary_format
+    };
+
+      // Levels are normally LEVEL_WIDTH x LEVEL_HEIGHT, but any rectangular
+      // maze up to MAX_LEVEL_DIMENSION on a side is accepted.
+    static const int MIN_LEVEL_DIMENSION = 3;
+    static const int MAX_LEVEL_DIMENSION = 4096;
+
     Level(std::string assetPath)
-     : m_assetPath(assetPath)
+     : m_width(0), m_height(0), m_assetPath(assetPath)
     {
-        for (int y = 0; y < LEVEL_HEIGHT; y++)
-            for (int x = 0; x < LEVEL_WIDTH; x++)
-                m_maze[y][x] = empty;
+        resize(LEVEL_WIDTH, LEVEL_HEIGHT);
     }
 
     LoadResult loadLevel(std::string filename)
     {
-        std::ifstream levelFile((m_assetPath + filename).c_str());
-        if (!levelFile)
+        AssetData file;
+        if (!Assets().read(m_assetPath + filename, file))
             return load_fail_file_not_found;
+        std::string data(file.data(), file.size());
 
-          // get the maze
+          // Compiled levels start with a magic number; anything else is text
+        if (data.compare(0, BINARY_MAGIC_SIZE, "ZDLV") == 0)
+            return parseBinary(data);
+        return parseText(data);
+    }
+
+    bool saveLevel(std::string filename, SaveFormat format) const
+    {
+        std::ofstream levelFile((m_assetPath + filename).c_str(), std::ios::out|std::ios::binary);
+        if (!levelFile)
+            return false;
+
+        if (format == binary_format)
+        {
+            unsigned char header[BINARY_HEADER_SIZE] = {
+                'Z', 'D', 'L', 'V', BINARY_VERSION, 0,
+                static_cast<unsigned char>(m_width & 0xff), static_cast<unsigned char>(m_width >> 8),
+                static_cast<unsigned char>(m_height & 0xff), static_cast<unsigned char>(m_height >> 8)
+            };
+            levelFile.write(reinterpret_cast<const char*>(header), BINARY_HEADER_SIZE);
+            std::string row(m_width, '\0');
+            for (int y = m_height-1; y >= 0; y--)
+            {
+                for (int x = 0; x < m_width; x++)
+                    row[x] = static_cast<char>(getContentsOf(x, y));
+                levelFile.write(row.data(), m_width);
+            }
+        }
+        else
+        {
+            std::string row(m_width, ' ');
+            for (int y = m_height-1; y >= 0; y--)
+            {
+                for (int x = 0; x < m_width; x++)
+                    row[x] = entryToChar(getContentsOf(x, y));
+                levelFile << row << '\n';
+            }
+        }
+        return static_cast<bool>(levelFile);
+    }
+
+    MazeEntry getContentsOf(int x, int y) const
+    {
+        return (x >= 0 && x < m_width && y >= 0 && y < m_height) ? m_maze[y * m_width + x] : empty;
+    }
 
+    void setContentsOf(int x, int y, MazeEntry me)
+    {
+        if (x >= 0 && x < m_width && y >= 0 && y < m_height)
+            m_maze[y * m_width + x] = me;
+    }
+
+    int getWidth() const
+    {
+        return m_width;
+    }
+
+    int getHeight() const
+    {
+        return m_height;
+    }
+
+      // Discard the current maze and make an empty one of the given size
+    void resize(int width, int height)
+    {
+        m_width = width;
+        m_height = height;
+        m_maze.assign(static_cast<size_t>(width) * height, empty);
+    }
+
+private:
+    std::vector<MazeEntry> m_maze;      // row-major, row 0 is the bottom row
+    int         m_width;
+    int         m_height;
+    std::string m_assetPath;
+
+      // Compiled level layout (all multi-byte fields little-endian):
+      //   bytes 0-3  "ZDLV"
+      //   byte  4    format version
+      //   byte  5    reserved (0)
+      //   bytes 6-7  width
+      //   bytes 8-9  height
+      //   then width*height MazeEntry bytes, top row first
+    static const int BINARY_MAGIC_SIZE = 4;
+    static const int BINARY_HEADER_SIZE = 10;
+    static const unsigned char BINARY_VERSION = 1;
+
+    LoadResult parseText(const std::string& data)
+    {
+        std::istringstream levelFile(data);
+        std::vector<std::string> rows;
         std::string line;
+        bool sawBlankLine = false;
+
+        while (std::getline(levelFile, line))
+        {
+            size_t end = line.find_last_not_of(" \t\r");
+            if (end == std::string::npos)
+            {
+                sawBlankLine = true;    // only blank lines may follow the maze
+                continue;
+            }
+            if (sawBlankLine  ||  static_cast<int>(rows.size()) >= MAX_LEVEL_DIMENSION)
+                return load_fail_bad_format;
+            rows.push_back(line.substr(0, end+1));
+        }
+
+        if (rows.empty())
+            return load_fail_bad_format;
+
+        int width = static_cast<int>(rows[0].size());
+        int height = static_cast<int>(rows.size());
+        if (!dimensionsValid(width, height))
+            return load_fail_bad_format;
+
+        resize(width, height);
+
+          // get the maze
+
         bool foundExit = false;
         bool foundPlayer = false;
 
-        for (int y = LEVEL_HEIGHT-1; std::getline(levelFile, line); y--)
+        for (int r = 0; r < height; r++)
         {
-            if (y < 0)    // too many maze lines?
-            {
-                if (line.find_first_not_of(" \t\r") != std::string::npos)
-                    return load_fail_bad_format;  // non-blank line
+            const std::string& row = rows[r];
+            if (static_cast<int>(row.size()) != width)
+                return load_fail_bad_format;
 
-                char dummy;
-                if (levelFile >> dummy)     // non-blank rest of file
+            int y = height-1 - r;
+            for (int x = 0; x < width; x++)
+            {
+                MazeEntry me;
+                if (!charToEntry(row[x], me))
                     return load_fail_bad_format;
-                break;
+                if (me == exit)
+                    foundExit = true;
+                else if (me == player)
+                    foundPlayer = true;
+                m_maze[y * width + x] = me;
             }
+        }
 
-            if (line.size() < LEVEL_WIDTH  ||  line.find_first_not_of(" \t\r", LEVEL_WIDTH) != std::string::npos)
-                return load_fail_bad_format;
-                
-            for (int x = 0; x < LEVEL_WIDTH; x++)
+        if (!foundExit  ||  !foundPlayer  ||  !edgesValid())
+            return load_fail_bad_format;
+
+        return load_success;
+    }
+
+    LoadResult parseBinary(const std::string& data)
+    {
+        if (data.size() < BINARY_HEADER_SIZE)
+            return load_fail_bad_format;
+
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+        if (bytes[4] != BINARY_VERSION)
+            return load_fail_bad_format;
+
+        int width = bytes[6] | (bytes[7] << 8);
+        int height = bytes[8] | (bytes[9] << 8);
+        if (!dimensionsValid(width, height)  ||
+                data.size() != BINARY_HEADER_SIZE + static_cast<size_t>(width) * height)
+            return load_fail_bad_format;
+
+        resize(width, height);
+
+        bool foundExit = false;
+        bool foundPlayer = false;
+        const unsigned char* cell = bytes + BINARY_HEADER_SIZE;
+
+        for (int y = height-1; y >= 0; y--)
+        {
+            for (int x = 0; x < width; x++, cell++)
             {
-                MazeEntry& me = m_maze[y][x];
-                switch (toupper(line[x]))
-                {
-                    default:   return load_fail_bad_format;
-                    case ' ':  me = empty;                      break;
-                    case 'X':  me = exit;   foundExit = true;   break;
-                    case '@':  me = player; foundPlayer = true; break;
-                    case 'D':  me = dumb_zombie;                break;
-                    case 'S':  me = smart_zombie;               break;
-                    case 'C':  me = citizen;                    break;
-                    case '#':  me = wall;                       break;
-                    case 'O':  me = pit;                        break;
-                    case 'V':  me = vaccine_goodie;             break;
-                    case 'G':  me = gas_can_goodie;             break;
-                    case 'L':  me = landmine_goodie;            break;
-                }
+                if (*cell > landmine_goodie)
+                    return load_fail_bad_format;
+                MazeEntry me = static_cast<MazeEntry>(*cell);
+                if (me == exit)
+                    foundExit = true;
+                else if (me == player)
+                    foundPlayer = true;
+                m_maze[y * width + x] = me;
             }
         }
 
@@ -83,22 +235,58 @@ public:
         return load_success;
     }
 
-    MazeEntry getContentsOf(int x, int y) const
+    static bool dimensionsValid(int width, int height)
     {
-        return (x >= 0 && x < LEVEL_WIDTH && y >= 0 && y < LEVEL_HEIGHT) ? m_maze[y][x] : empty;
+        return width >= MIN_LEVEL_DIMENSION  &&  width <= MAX_LEVEL_DIMENSION  &&
+               height >= MIN_LEVEL_DIMENSION  &&  height <= MAX_LEVEL_DIMENSION;
     }
 
-private:
-    MazeEntry   m_maze[LEVEL_HEIGHT][LEVEL_WIDTH];
-    std::string m_assetPath;
+    static bool charToEntry(char c, MazeEntry& me)
+    {
+        switch (toupper(c))
+        {
+            default:   return false;
+            case ' ':  me = empty;              break;
+            case 'X':  me = exit;               break;
+            case '@':  me = player;             break;
+            case 'D':  me = dumb_zombie;        break;
+            case 'S':  me = smart_zombie;       break;
+            case 'C':  me = citizen;            break;
+            case '#':  me = wall;               break;
+            case 'O':  me = pit;                break;
+            case 'V':  me = vaccine_goodie;     break;
+            case 'G':  me = gas_can_goodie;     break;
+            case 'L':  me = landmine_goodie;    break;
+        }
+        return true;
+    }
+
+    static char entryToChar(MazeEntry me)
+    {
+        switch (me)
+        {
+            default:
+            case empty:             return ' ';
+            case exit:              return 'X';
+            case player:            return '@';
+            case dumb_zombie:       return 'D';
+            case smart_zombie:      return 'S';
+            case citizen:           return 'C';
+            case wall:              return '#';
+            case pit:               return 'O';
+            case vaccine_goodie:    return 'V';
+            case gas_can_goodie:    return 'G';
+            case landmine_goodie:   return 'L';
+        }
+    }
 
     bool edgesValid() const
     {
-        for (int y = 0; y < LEVEL_HEIGHT; y++)
-            if (m_maze[y][0] != wall || m_maze[y][LEVEL_WIDTH-1] != wall)
+        for (int y = 0; y < m_height; y++)
+            if (getContentsOf(0, y) != wall || getContentsOf(m_width-1, y) != wall)
                 return false;
-        for (int x = 0; x < LEVEL_WIDTH; x++)
-            if (m_maze[0][x] != wall || m_maze[LEVEL_HEIGHT-1][x] != wall)
+        for (int x = 0; x < m_width; x++)
+            if (getContentsOf(x, 0) != wall || getContentsOf(x, m_height-1) != wall)
                 return false;
 
         return true;
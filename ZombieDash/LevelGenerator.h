@@ -0,0 +1,213 @@
+#ifndef LEVELGENERATOR_H_
+#define LEVELGENERATOR_H_
+
+#include "Level.h"
+#include <string>
+#include <vector>
+#include <queue>
+#include <random>
+#include <utility>
+
+  // Densities are the fraction of interior cells (not counting the border
+  // walls, the player and the exit) that receive each kind of content.
+
+struct LevelGenParams
+{
+    int      width;
+    int      height;
+    double   wallDensity;
+    double   pitDensity;
+    double   citizenDensity;
+    double   dumbZombieDensity;
+    double   smartZombieDensity;
+    double   goodieDensity;
+    unsigned seed;
+};
+
+class LevelGenerator
+{
+public:
+
+    struct Scenario
+    {
+        const char*    name;
+        LevelGenParams params;
+    };
+
+      // The standard benchmarking scenarios
+    static const std::vector<Scenario>& standardScenarios()
+    {
+        static const std::vector<Scenario> scenarios = {
+              //            w    h   walls  pits   cits  dumb   smart  goodies seed
+            { "small",  {  16,  16, .10,   .02,   .03,  .03,   .01,   .02,    1 } },
+            { "medium", {  64,  64, .10,   .02,   .03,  .03,   .01,   .02,    2 } },
+            { "huge",   { 256, 256, .10,   .02,   .03,  .03,   .01,   .02,    3 } },
+            { "horde",  {  64,  64, .05,   .01,   .05,  .20,   .10,   .02,    4 } },
+            { "calm",   {  64,  64, .10,   .02,   0,    0,     0,     .02,    5 } },
+        };
+        return scenarios;
+    }
+
+    static bool findScenario(std::string name, LevelGenParams& params)
+    {
+        for (const Scenario& s : standardScenarios())
+        {
+            if (name == s.name)
+            {
+                params = s.params;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool paramsValid(const LevelGenParams& p)
+    {
+        double densities[] = { p.wallDensity, p.pitDensity, p.citizenDensity,
+                               p.dumbZombieDensity, p.smartZombieDensity, p.goodieDensity };
+        double total = 0;
+        for (double d : densities)
+        {
+            if (d < 0)
+                return false;
+            total += d;
+        }
+          // need room inside the border for at least the player and the exit
+        return total <= 1  &&
+               p.width >= Level::MIN_LEVEL_DIMENSION  &&  p.width <= Level::MAX_LEVEL_DIMENSION  &&
+               p.height >= Level::MIN_LEVEL_DIMENSION  &&  p.height <= Level::MAX_LEVEL_DIMENSION  &&
+               (p.width - 2) * (p.height - 2) >= 2;
+    }
+
+      // Fill lev with a random maze that Level::loadLevel would accept:
+      // walls all around the edge, exactly one player, and an exit the
+      // player can walk to.  The same params always produce the same maze.
+    static bool generate(const LevelGenParams& p, Level& lev)
+    {
+        if (!paramsValid(p))
+            return false;
+
+        std::mt19937 rng(p.seed);
+        lev.resize(p.width, p.height);
+
+        for (int x = 0; x < p.width; x++)
+        {
+            lev.setContentsOf(x, 0, Level::wall);
+            lev.setContentsOf(x, p.height-1, Level::wall);
+        }
+        for (int y = 0; y < p.height; y++)
+        {
+            lev.setContentsOf(0, y, Level::wall);
+            lev.setContentsOf(p.width-1, y, Level::wall);
+        }
+
+        std::uniform_int_distribution<int> randX(1, p.width-2);
+        std::uniform_int_distribution<int> randY(1, p.height-2);
+        int playerX = randX(rng);
+        int playerY = randY(rng);
+        int exitX, exitY;
+        do
+        {
+            exitX = randX(rng);
+            exitY = randY(rng);
+        } while (exitX == playerX  &&  exitY == playerY);
+
+        lev.setContentsOf(playerX, playerY, Level::player);
+        lev.setContentsOf(exitX, exitY, Level::exit);
+
+        const Level::MazeEntry goodies[] = {
+            Level::vaccine_goodie, Level::gas_can_goodie, Level::landmine_goodie
+        };
+        std::uniform_real_distribution<double> roll(0, 1);
+        std::uniform_int_distribution<int> randGoodie(0, 2);
+
+        for (int y = 1; y < p.height-1; y++)
+        {
+            for (int x = 1; x < p.width-1; x++)
+            {
+                if (lev.getContentsOf(x, y) != Level::empty)
+                    continue;
+
+                  // walk the cumulative distribution of densities
+                double r = roll(rng);
+                if ((r -= p.wallDensity) < 0)
+                    lev.setContentsOf(x, y, Level::wall);
+                else if ((r -= p.pitDensity) < 0)
+                    lev.setContentsOf(x, y, Level::pit);
+                else if ((r -= p.citizenDensity) < 0)
+                    lev.setContentsOf(x, y, Level::citizen);
+                else if ((r -= p.dumbZombieDensity) < 0)
+                    lev.setContentsOf(x, y, Level::dumb_zombie);
+                else if ((r -= p.smartZombieDensity) < 0)
+                    lev.setContentsOf(x, y, Level::smart_zombie);
+                else if ((r -= p.goodieDensity) < 0)
+                    lev.setContentsOf(x, y, goodies[randGoodie(rng)]);
+            }
+        }
+
+        if (!isReachable(lev, playerX, playerY, exitX, exitY))
+            carvePath(lev, playerX, playerY, exitX, exitY);
+
+        return true;
+    }
+
+private:
+
+    static bool isPassable(Level::MazeEntry me)
+    {
+        return me != Level::wall  &&  me != Level::pit;
+    }
+
+      // Breadth-first search over cells the player can walk through
+    static bool isReachable(const Level& lev, int fromX, int fromY, int toX, int toY)
+    {
+        int width = lev.getWidth();
+        std::vector<bool> visited(static_cast<size_t>(width) * lev.getHeight(), false);
+        std::queue<std::pair<int, int>> frontier;
+        frontier.push(std::make_pair(fromX, fromY));
+        visited[fromY * width + fromX] = true;
+
+        static const int dx[] = { 1, -1, 0, 0 };
+        static const int dy[] = { 0, 0, 1, -1 };
+
+        while (!frontier.empty())
+        {
+            std::pair<int, int> cur = frontier.front();
+            frontier.pop();
+            if (cur.first == toX  &&  cur.second == toY)
+                return true;
+
+            for (int k = 0; k < 4; k++)
+            {
+                int nx = cur.first + dx[k];
+                int ny = cur.second + dy[k];
+                if (!visited[ny * width + nx]  &&  isPassable(lev.getContentsOf(nx, ny)))
+                {
+                    visited[ny * width + nx] = true;
+                    frontier.push(std::make_pair(nx, ny));
+                }
+            }
+        }
+        return false;
+    }
+
+      // Clear an L-shaped corridor (horizontal, then vertical) from the
+      // player to the exit.  Neither leg touches the border walls.
+    static void carvePath(Level& lev, int fromX, int fromY, int toX, int toY)
+    {
+        int stepX = (toX > fromX ? 1 : -1);
+        for (int x = fromX; x != toX; x += stepX)
+        {
+            if (!isPassable(lev.getContentsOf(x, fromY)))
+                lev.setContentsOf(x, fromY, Level::empty);
+        }
+        int stepY = (toY > fromY ? 1 : -1);
+        for (int y = fromY; y != toY; y += stepY)
+        {
+            if (!isPassable(lev.getContentsOf(toX, y)))
+                lev.setContentsOf(toX, y, Level::empty);
+        }
+    }
+};
+
+#endif // LEVELGENERATOR_H_
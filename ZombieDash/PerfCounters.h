@@ -0,0 +1,305 @@
+#ifndef PERFCOUNTERS_H_
+#define PERFCOUNTERS_H_
+
+#include <atomic>
+#include <algorithm>
+#include <ostream>
+#include <cstdio>
+
+  // Cheap counters for the in-game performance overlay.  Every update is a
+  // single relaxed atomic operation, so they can be bumped from any thread
+  // on a hot path; readers get a consistent-enough picture without locking.
+
+  // The most recent NUM_SAMPLES durations (in microseconds) of something
+  // that happens repeatedly, e.g. a frame or a tick.
+class RollingTimer
+{
+  public:
+    static const int NUM_SAMPLES = 128;
+
+    RollingTimer()
+     : m_next(0)
+    {
+        for (int k = 0; k < NUM_SAMPLES; k++)
+            m_samples[k].store(0, std::memory_order_relaxed);
+    }
+
+    void record(long long microseconds)
+    {
+        unsigned int k = m_next.fetch_add(1, std::memory_order_relaxed);
+        m_samples[k % NUM_SAMPLES].store(static_cast<int>(microseconds), std::memory_order_relaxed);
+    }
+
+      // Most recent sample and the median and 99th percentile of the
+      // retained samples, all in microseconds
+    void summarize(int& last, int& p50, int& p99) const
+    {
+        unsigned int next = m_next.load(std::memory_order_relaxed);
+        int n = static_cast<int>(std::min<unsigned int>(next, NUM_SAMPLES));
+        if (n == 0)
+        {
+            last = p50 = p99 = 0;
+            return;
+        }
+        int sorted[NUM_SAMPLES];
+        for (int k = 0; k < n; k++)
+            sorted[k] = m_samples[k].load(std::memory_order_relaxed);
+        last = m_samples[(next - 1) % NUM_SAMPLES].load(std::memory_order_relaxed);
+        std::sort(sorted, sorted + n);
+        p50 = sorted[(n - 1) / 2];
+        p99 = sorted[(n - 1) * 99 / 100];
+    }
+
+  private:
+    std::atomic<unsigned int> m_next;
+    std::atomic<int>          m_samples[NUM_SAMPLES];
+};
+
+  // How many durations (in microseconds) fell in each of a fixed set of
+  // buckets, HDR histogram style: one bucket per microsecond up to 32, then
+  // SUB_BUCKETS per doubling, so a bucket's values are all within about 6%
+  // of each other.  It covers an hour in under 2 KB and never allocates,
+  // however many samples are recorded.
+class LatencyHistogram
+{
+  public:
+    static const int SUB_BUCKET_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int NUM_BUCKETS = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram()
+     : m_count(0), m_max(0)
+    {
+        for (int k = 0; k < NUM_BUCKETS; k++)
+            m_buckets[k].store(0, std::memory_order_relaxed);
+    }
+
+    void record(long long microseconds)
+    {
+        unsigned int v = static_cast<unsigned int>(std::max(0LL, std::min(microseconds, 0xffffffffLL)));
+        m_buckets[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        unsigned int max = m_max.load(std::memory_order_relaxed);
+        while (v > max  &&  !m_max.compare_exchange_weak(max, v, std::memory_order_relaxed))
+            ;
+    }
+
+    long long count() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    long long maxValue() const
+    {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+      // The largest value in the bucket holding the given percentile of the
+      // samples, or 0 if there are none
+    long long valueAtPercentile(double percentile) const
+    {
+        long long total = count();
+        if (total == 0)
+            return 0;
+        long long target = std::max(1LL, static_cast<long long>(total * percentile / 100 + 0.5));
+        long long seen = 0;
+        for (int k = 0; k < NUM_BUCKETS; k++)
+        {
+            seen += m_buckets[k].load(std::memory_order_relaxed);
+            if (seen >= target)
+                return std::min(bucketHigh(k), maxValue());
+        }
+        return maxValue();
+    }
+
+      // Percentiles, then every bucket that isn't empty
+    void dump(std::ostream& out, const char* name) const
+    {
+        char text[256];
+        snprintf(text, sizeof(text), "%s: %lld samples, p50 %lld us, p90 %lld us, p99 %lld us, p99.9 %lld us, max %lld us",
+                 name, count(), valueAtPercentile(50), valueAtPercentile(90), valueAtPercentile(99),
+                 valueAtPercentile(99.9), maxValue());
+        out << text << "\n";
+        for (int k = 0; k < NUM_BUCKETS; k++)
+        {
+            long long n = m_buckets[k].load(std::memory_order_relaxed);
+            if (n > 0)
+            {
+                snprintf(text, sizeof(text), "  %10lld - %10lld us  %lld", bucketLow(k), bucketHigh(k), n);
+                out << text << "\n";
+            }
+        }
+    }
+
+  private:
+    std::atomic<unsigned int>  m_buckets[NUM_BUCKETS];
+    std::atomic<long long>     m_count;
+    std::atomic<unsigned int>  m_max;
+
+      // Bucket k covers (k - g*SUB_BUCKETS) << g and the 2^g - 1 values
+      // after it, where g is how many times the value was halved to get it
+      // below 2*SUB_BUCKETS
+    static int bucketOf(unsigned int v)
+    {
+        int g = 0;
+        while ((v >> g) >= 2 * SUB_BUCKETS)
+            g++;
+        return g * SUB_BUCKETS + static_cast<int>(v >> g);
+    }
+
+    static int halvings(int k)
+    {
+        return k < 2 * SUB_BUCKETS ? 0 : k / SUB_BUCKETS - 1;
+    }
+
+    static long long bucketLow(int k)
+    {
+        int g = halvings(k);
+        return static_cast<long long>(k - g * SUB_BUCKETS) << g;
+    }
+
+    static long long bucketHigh(int k)
+    {
+        return bucketLow(k) + (1LL << halvings(k)) - 1;
+    }
+};
+
+class PerfCounters
+{
+  public:
+    static const int MAX_IMAGE_ID = 32;
+
+    RollingTimer frameTime;
+    RollingTimer tickTime;
+
+      // For each key press, how long until a tick used it, and until the
+      // first frame showing that tick was swapped onto the screen
+    LatencyHistogram inputToTick;
+    LatencyHistogram inputToDisplay;
+
+      // Live GraphObjects, by image ID
+
+    void objectCreated(int imageID)
+    {
+        if (imageID >= 0  &&  imageID < MAX_IMAGE_ID)
+            m_liveObjects[imageID].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void objectDestroyed(int imageID)
+    {
+        if (imageID >= 0  &&  imageID < MAX_IMAGE_ID)
+            m_liveObjects[imageID].fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    int liveObjects(int imageID) const
+    {
+        return (imageID >= 0  &&  imageID < MAX_IMAGE_ID) ?
+                    m_liveObjects[imageID].load(std::memory_order_relaxed) : 0;
+    }
+
+      // Per-frame rendering work; endFrame() publishes this frame's totals
+
+    void spriteDrawn()
+    {
+        m_spritesThisFrame.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void textureBound(int n = 1)
+    {
+        m_texturesThisFrame.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void drawCallIssued(int n = 1)
+    {
+        m_drawCallsThisFrame.fetch_add(n, std::memory_order_relaxed);
+    }
+
+      // Blend, texturing, and transform state set up for drawing
+    void stateChanged()
+    {
+        m_stateChangesThisFrame.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void endFrame()
+    {
+        m_spritesLastFrame.store(m_spritesThisFrame.exchange(0, std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+        m_texturesLastFrame.store(m_texturesThisFrame.exchange(0, std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+        m_drawCallsLastFrame.store(m_drawCallsThisFrame.exchange(0, std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+        m_stateChangesLastFrame.store(m_stateChangesThisFrame.exchange(0, std::memory_order_relaxed),
+                                      std::memory_order_relaxed);
+    }
+
+    int spritesLastFrame() const
+    {
+        return m_spritesLastFrame.load(std::memory_order_relaxed);
+    }
+
+    int textureBindsLastFrame() const
+    {
+        return m_texturesLastFrame.load(std::memory_order_relaxed);
+    }
+
+    int drawCallsLastFrame() const
+    {
+        return m_drawCallsLastFrame.load(std::memory_order_relaxed);
+    }
+
+    int stateChangesLastFrame() const
+    {
+        return m_stateChangesLastFrame.load(std::memory_order_relaxed);
+    }
+
+      // Heap allocations made during the most recent tick
+
+    void setTickAllocations(long long n)
+    {
+        m_tickAllocations.store(n, std::memory_order_relaxed);
+    }
+
+    long long tickAllocations() const
+    {
+        return m_tickAllocations.load(std::memory_order_relaxed);
+    }
+
+      // Meyers singleton pattern
+    static PerfCounters& getInstance()
+    {
+        static PerfCounters instance;
+        return instance;
+    }
+
+  private:
+    std::atomic<int>       m_liveObjects[MAX_IMAGE_ID];
+    std::atomic<int>       m_spritesThisFrame;
+    std::atomic<int>       m_spritesLastFrame;
+    std::atomic<int>       m_texturesThisFrame;
+    std::atomic<int>       m_texturesLastFrame;
+    std::atomic<int>       m_drawCallsThisFrame;
+    std::atomic<int>       m_drawCallsLastFrame;
+    std::atomic<int>       m_stateChangesThisFrame;
+    std::atomic<int>       m_stateChangesLastFrame;
+    std::atomic<long long> m_tickAllocations;
+
+    PerfCounters()
+     : m_spritesThisFrame(0), m_spritesLastFrame(0),
+       m_texturesThisFrame(0), m_texturesLastFrame(0), m_drawCallsThisFrame(0),
+       m_drawCallsLastFrame(0), m_stateChangesThisFrame(0), m_stateChangesLastFrame(0),
+       m_tickAllocations(0)
+    {
+        for (int k = 0; k < MAX_IMAGE_ID; k++)
+            m_liveObjects[k].store(0, std::memory_order_relaxed);
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+};
+
+inline PerfCounters& Perf()
+{
+    return PerfCounters::getInstance();
+}
+
+#endif // PERFCOUNTERS_H_
@@ -0,0 +1,405 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+  // Per-tick hierarchical profiler.  Build with ZOMBIEDASH_PROFILE defined
+  // to turn it on; otherwise every PROFILE_ macro compiles to nothing.
+  //
+  //   PROFILE_TICK()                 one profiler tick for the enclosing block
+  //   PROFILE_SCOPE(name)            time the enclosing block
+  //   PROFILE_ACTOR_SCOPE(name, a)   same, tagged with actor a's address and position
+  //   PROFILE_QUERY(id)              time a world query and count the call
+  //   PROFILE_QUERY_SCANNED()        count one actor examined by that query
+  //
+  // The last NUM_TICKS ticks are kept in a ring buffer and can be written as
+  // Chrome trace-event JSON, which chrome://tracing and Perfetto can open.
+  // A tick slower than SLOW_TICK_MS is written out automatically: the ring
+  // is copied while the tick ends, and a thread of the profiler's own
+  // writes the copy, so the ticks after a slow one aren't held up by it.
+  //
+  // Ticks are begun and ended by the simulation thread, but events may be
+  // recorded from any thread.  An event recorded between ticks (e.g. a
+  // frame drawn on the render thread) is filed with the previous tick.
+
+#ifdef ZOMBIEDASH_PROFILE
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+class Profiler
+{
+  public:
+
+    enum Query {
+        query_agent_movement_blocked, query_flame_blocked,
+        query_zombie_vomit_trigger, query_activate_on_appropriate_actors,
+        NUM_QUERIES
+    };
+
+    static const int NUM_TICKS = 256;
+    static const int MAX_EVENTS_PER_TICK = 65536;
+    static const int SLOW_TICK_MS = 50;
+    static const int SLOW_TICK_DUMP_INTERVAL_MS = 10000;
+
+    struct Event
+    {
+        const char* name;
+        long long   startNs;
+        long long   durationNs;
+        const void* actor;      // nullptr if not an actor's scope
+        double      x;
+        double      y;
+        int         scanned;    // -1 if not a query
+        int         thread;     // small per-thread number, for the trace's tid
+    };
+
+    void beginTick()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TickRecord& t = m_ticks[m_tickCount % NUM_TICKS];
+        t.number = m_tickCount;
+        t.startNs = nowNs();
+        t.endNs = t.startNs;
+        t.thread = threadNumber();
+        t.events.clear();
+        t.droppedEvents = 0;
+        for (int q = 0; q < NUM_QUERIES; q++)
+            t.queryCalls[q] = t.queryScanned[q] = 0;
+        m_inTick = true;
+    }
+
+    void endTick()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_inTick)
+                return;
+            TickRecord& t = m_ticks[m_tickCount % NUM_TICKS];
+            t.endNs = nowNs();
+            m_tickCount++;
+            m_inTick = false;
+
+            long long durationNs = t.endNs - t.startNs;
+            if (durationNs <= SLOW_TICK_MS * 1000000LL  ||  m_slowTickPending  ||
+                (m_lastSlowDumpNs >= 0  &&  t.endNs - m_lastSlowDumpNs <= SLOW_TICK_DUMP_INTERVAL_MS * 1000000LL))
+                return;
+            m_lastSlowDumpNs = t.endNs;
+            copyTicks(m_slowTicks);
+            m_slowTickMs = durationNs / 1000000;
+            m_slowTickPending = true;
+        }
+        m_slowTickReady.notify_one();
+    }
+
+    void recordEvent(Event e)
+    {
+        e.thread = threadNumber();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TickRecord* t = currentRecord();
+        if (t == nullptr)
+            return;
+        if (static_cast<int>(t->events.size()) < MAX_EVENTS_PER_TICK)
+            t->events.push_back(e);
+        else
+            t->droppedEvents++;
+    }
+
+    void recordQuery(Query q, int scanned)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TickRecord* t = currentRecord();
+        if (t == nullptr)
+            return;
+        t->queryCalls[q]++;
+        t->queryScanned[q] += scanned;
+    }
+
+    static const char* queryName(Query q)
+    {
+        static const char* const names[NUM_QUERIES] = {
+            "isAgentMovementBlockedAt", "isFlameBlockedAt",
+            "isZombieVomitTriggerAt", "activateOnAppropriateActors"
+        };
+        return names[q];
+    }
+
+    long long nowNs() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - m_epoch).count();
+    }
+
+    bool writeChromeTrace(std::string filename) const
+    {
+        std::vector<TickRecord> ticks;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            copyTicks(ticks);
+        }
+        return writeTicks(filename, ticks);
+    }
+
+      // Meyers singleton pattern
+    static Profiler& getInstance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+  private:
+
+    struct TickRecord
+    {
+        long long          number;
+        long long          startNs;
+        long long          endNs;
+        int                thread;
+        std::vector<Event> events;
+        int                droppedEvents;
+        long long          queryCalls[NUM_QUERIES];
+        long long          queryScanned[NUM_QUERIES];
+    };
+
+    std::chrono::steady_clock::time_point m_epoch;
+    mutable std::mutex m_mutex;
+    TickRecord  m_ticks[NUM_TICKS];
+    long long   m_tickCount;
+    long long   m_lastSlowDumpNs;
+    bool        m_inTick;
+
+      // The ticks up to a slow one, copied by endTick for m_slowTickWriter
+      // to write; endTick leaves them alone while m_slowTickPending
+    std::vector<TickRecord> m_slowTicks;
+    long long               m_slowTickMs;
+    bool                    m_slowTickPending;
+    bool                    m_stopRequested;
+    std::condition_variable m_slowTickReady;
+    std::thread             m_slowTickWriter;
+
+    Profiler()
+     : m_epoch(std::chrono::steady_clock::now()), m_tickCount(0),
+       m_lastSlowDumpNs(-1), m_inTick(false), m_slowTickMs(0),
+       m_slowTickPending(false), m_stopRequested(false)
+    {
+        m_slowTickWriter = std::thread(&Profiler::writeSlowTicks, this);
+    }
+
+    ~Profiler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopRequested = true;
+        }
+        m_slowTickReady.notify_one();
+        m_slowTickWriter.join();
+    }
+
+      // The slow tick writer's thread
+    void writeSlowTicks()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;)
+        {
+            m_slowTickReady.wait(lock, [this] { return m_slowTickPending  ||  m_stopRequested; });
+            if (!m_slowTickPending)
+                return;
+            lock.unlock();
+            if (writeTicks("zombiedash_slowtick.json", m_slowTicks))
+                std::cout << "Slow tick (" << m_slowTickMs << " ms); "
+                          << "trace written to zombiedash_slowtick.json" << std::endl;
+            lock.lock();
+            m_slowTickPending = false;
+        }
+    }
+
+      // The ticks in the ring, oldest first; m_mutex must be held
+    void copyTicks(std::vector<TickRecord>& ticks) const
+    {
+        long long oldest = (m_tickCount > NUM_TICKS ? m_tickCount - NUM_TICKS : 0);
+        ticks.resize(static_cast<size_t>(m_tickCount - oldest));
+        for (long long n = oldest; n < m_tickCount; n++)
+            ticks[static_cast<size_t>(n - oldest)] = m_ticks[n % NUM_TICKS];
+    }
+
+    static bool writeTicks(const std::string& filename, const std::vector<TickRecord>& ticks)
+    {
+        std::ofstream out(filename);
+        if (!out)
+            return false;
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << std::fixed << std::setprecision(3);
+        bool first = true;
+        for (const TickRecord& t : ticks)
+        {
+            writeSeparator(out, first);
+            out << "{\"name\":\"tick " << t.number << "\",\"cat\":\"tick\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t.thread
+                << ",\"ts\":" << t.startNs / 1000.0 << ",\"dur\":" << (t.endNs - t.startNs) / 1000.0
+                << ",\"args\":{\"events\":" << t.events.size() << ",\"dropped\":" << t.droppedEvents << "}}";
+
+            for (const Event& e : t.events)
+            {
+                writeSeparator(out, first);
+                out << "{\"name\":\"" << e.name << "\",\"cat\":\""
+                    << (e.scanned >= 0 ? "query" : e.actor != nullptr ? "actor" : "phase")
+                    << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+                    << ",\"ts\":" << e.startNs / 1000.0 << ",\"dur\":" << e.durationNs / 1000.0;
+                if (e.actor != nullptr)
+                    out << ",\"args\":{\"actor\":\"" << e.actor << "\",\"x\":" << e.x << ",\"y\":" << e.y << "}";
+                else if (e.scanned >= 0)
+                    out << ",\"args\":{\"scanned\":" << e.scanned << "}";
+                out << "}";
+            }
+
+            for (int q = 0; q < NUM_QUERIES; q++)
+            {
+                writeSeparator(out, first);
+                out << "{\"name\":\"" << queryName(static_cast<Query>(q))
+                    << "\",\"ph\":\"C\",\"pid\":1,\"ts\":" << t.startNs / 1000.0
+                    << ",\"args\":{\"calls\":" << t.queryCalls[q]
+                    << ",\"scanned\":" << t.queryScanned[q] << "}}";
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+      // The tick in progress, or if none is, the last one finished
+    TickRecord* currentRecord()
+    {
+        if (m_inTick)
+            return &m_ticks[m_tickCount % NUM_TICKS];
+        if (m_tickCount > 0)
+            return &m_ticks[(m_tickCount - 1) % NUM_TICKS];
+        return nullptr;
+    }
+
+      // Threads are numbered 1, 2, ... in the order they first record
+    static int threadNumber()
+    {
+        static std::atomic<int> next(1);
+        thread_local int number = next.fetch_add(1);
+        return number;
+    }
+
+    static void writeSeparator(std::ostream& out, bool& first)
+    {
+        if (!first)
+            out << ",\n";
+        first = false;
+    }
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+};
+
+inline Profiler& Profile()
+{
+    return Profiler::getInstance();
+}
+
+class ProfileTick
+{
+  public:
+    ProfileTick()
+    {
+        Profile().beginTick();
+    }
+
+    ~ProfileTick()
+    {
+        Profile().endTick();
+    }
+};
+
+class ProfileScope
+{
+  public:
+    ProfileScope(const char* name)
+    {
+        m_event.name = name;
+        m_event.actor = nullptr;
+        m_event.x = m_event.y = 0;
+        m_event.scanned = -1;
+        m_event.startNs = Profile().nowNs();
+    }
+
+    template<typename ActorType>
+    ProfileScope(const char* name, const ActorType* actor)
+    {
+        m_event.name = name;
+        m_event.actor = actor;
+        m_event.x = actor->getX();
+        m_event.y = actor->getY();
+        m_event.scanned = -1;
+        m_event.startNs = Profile().nowNs();
+    }
+
+    ~ProfileScope()
+    {
+        m_event.durationNs = Profile().nowNs() - m_event.startNs;
+        Profile().recordEvent(m_event);
+    }
+
+  private:
+    Profiler::Event m_event;
+};
+
+class ProfileQueryScope
+{
+  public:
+    ProfileQueryScope(Profiler::Query q)
+     : m_query(q), m_scanned(0), m_startNs(Profile().nowNs())
+    {}
+
+    void scanned()
+    {
+        m_scanned++;
+    }
+
+    ~ProfileQueryScope()
+    {
+        Profiler::Event e;
+        e.name = Profiler::queryName(m_query);
+        e.startNs = m_startNs;
+        e.durationNs = Profile().nowNs() - m_startNs;
+        e.actor = nullptr;
+        e.x = e.y = 0;
+        e.scanned = m_scanned;
+        Profile().recordEvent(e);
+        Profile().recordQuery(m_query, m_scanned);
+    }
+
+  private:
+    Profiler::Query m_query;
+    int             m_scanned;
+    long long       m_startNs;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#define PROFILE_TICK()                  ProfileTick PROFILE_CONCAT(profileTick_, __LINE__)
+#define PROFILE_SCOPE(name)             ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_ACTOR_SCOPE(name, a)    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name, a)
+#define PROFILE_QUERY(id)               ProfileQueryScope profileQuery_(Profiler::id)
+#define PROFILE_QUERY_SCANNED()         profileQuery_.scanned()
+
+#else  // profiling compiled out
+
+#define PROFILE_TICK()                  ((void)0)
+#define PROFILE_SCOPE(name)             ((void)0)
+#define PROFILE_ACTOR_SCOPE(name, a)    ((void)0)
+#define PROFILE_QUERY(id)               ((void)0)
+#define PROFILE_QUERY_SCANNED()         ((void)0)
+
+#endif // ZOMBIEDASH_PROFILE
+
+#endif // PROFILER_H_
@@ -0,0 +1,136 @@
+#ifndef RENDERQUEUE_H_
+#define RENDERQUEUE_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+  // One frame's draw items, sorted so that those needing the same OpenGL
+  // state end up next to each other.  Each item is a 32-bit sort key plus
+  // a 32-bit payload (typically an index into the caller's own sprite
+  // list).  Keys order items back to front by depth, then by atlas page,
+  // then by image ID; items with equal keys keep the order they were
+  // pushed in.  Sorting is a byte-at-a-time radix sort into a scratch
+  // array, so once the vectors have grown to fit a frame, building and
+  // sorting a queue never allocates.
+class RenderQueue
+{
+  public:
+    struct Item
+    {
+        std::uint32_t key;
+        std::uint32_t payload;
+    };
+
+    static const int MAX_DEPTH = 255;
+    static const int MAX_PAGE = 255;
+    static const int MAX_IMAGE_ID = 65535;
+
+    void clear()
+    {
+        m_items.clear();
+    }
+
+    void push(int depth, int page, int imageID, std::uint32_t payload)
+    {
+        m_items.push_back(Item{ makeKey(depth, page, imageID), payload });
+    }
+
+    void sort()
+    {
+          // Count every byte position's digits in one pass over the keys
+        size_t counts[KEY_BYTES][256] = { { 0 } };
+        for (const Item& item : m_items)
+        {
+            for (int b = 0; b < KEY_BYTES; b++)
+                counts[b][(item.key >> (8 * b)) & 0xff]++;
+        }
+
+        m_scratch.resize(m_items.size());
+        for (int b = 0; b < KEY_BYTES; b++)
+        {
+              // A byte that is the same in every key can't change the order
+            int shift = 8 * b;
+            if (m_items.empty()  ||  counts[b][(m_items[0].key >> shift) & 0xff] == m_items.size())
+                continue;
+
+            size_t offset = 0;
+            for (size_t& c : counts[b])
+            {
+                size_t n = c;
+                c = offset;
+                offset += n;
+            }
+            for (const Item& item : m_items)
+                m_scratch[counts[b][(item.key >> shift) & 0xff]++] = item;
+            m_items.swap(m_scratch);
+        }
+    }
+
+    size_t size() const
+    {
+        return m_items.size();
+    }
+
+    bool empty() const
+    {
+        return m_items.empty();
+    }
+
+    const Item& operator[](size_t k) const
+    {
+        return m_items[k];
+    }
+
+    static int pageOf(const Item& item)
+    {
+        return static_cast<int>((item.key >> 16) & 0xff);
+    }
+
+    static int imageIDOf(const Item& item)
+    {
+        return static_cast<int>(item.key & 0xffff);
+    }
+
+      // Call runFunc(page, first, count) for each maximal run of consecutive
+      // items on the same atlas page; each run can be drawn with one bind
+      // and one draw call.  Returns the number of runs.
+    template<typename Func>
+    int forEachRun(Func runFunc) const
+    {
+        int runs = 0;
+        size_t first = 0;
+        while (first < m_items.size())
+        {
+            int page = pageOf(m_items[first]);
+            size_t last = first + 1;
+            while (last < m_items.size()  &&  pageOf(m_items[last]) == page)
+                last++;
+            runFunc(page, first, last - first);
+            runs++;
+            first = last;
+        }
+        return runs;
+    }
+
+  private:
+    static const int KEY_BYTES = 4;
+
+    std::vector<Item> m_items;
+    std::vector<Item> m_scratch;
+
+    static std::uint32_t clamp(int n, int maxValue)
+    {
+        return static_cast<std::uint32_t>(n < 0 ? 0 : (n > maxValue ? maxValue : n));
+    }
+
+    static std::uint32_t makeKey(int depth, int page, int imageID)
+    {
+          // Greater depths are farther away, so they sort first
+        return (MAX_DEPTH - clamp(depth, MAX_DEPTH)) << 24  |
+               clamp(page, MAX_PAGE) << 16  |
+               clamp(imageID, MAX_IMAGE_ID);
+    }
+};
+
+#endif // RENDERQUEUE_H_
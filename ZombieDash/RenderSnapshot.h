@@ -0,0 +1,70 @@
+#ifndef RENDERSNAPSHOT_H_
+#define RENDERSNAPSHOT_H_
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+  // Everything the render thread needs to draw one frame.  The simulation
+  // thread fills one in at the end of each tick and publishes it; after
+  // that it is never modified until it is recycled for a later tick.
+
+struct SpriteInstance
+{
+    int    imageID;
+    int    frame;
+    double fromX;       // position before the tick (for interpolation)
+    double fromY;
+    double x;           // position after the tick
+    double y;
+    int    direction;
+    double size;
+    int    depth;
+    long long serial;   // the same for one object from snapshot to snapshot
+};
+
+  // A key press a tick used, for measuring input latency
+struct InputStamp
+{
+    long long                             id;     // 0 if none; increases with each key used
+    std::chrono::steady_clock::time_point received;
+};
+
+struct RenderSnapshot
+{
+    enum Mode {
+        mode_blank, mode_gameplay, mode_prompt
+    };
+
+    RenderSnapshot()
+     : mode(mode_blank), sequence(0), interpolate(false), input{ 0, {} },
+       hudVersion(-1), cameraFromX(0), cameraFromY(0), cameraX(0), cameraY(0), staticVersion(-1)
+    {}
+
+    Mode        mode;
+    long long   sequence;       // increases with each published snapshot
+    bool        interpolate;    // false: draw sprites at x, y only
+    std::chrono::steady_clock::time_point publishTime;
+    InputStamp  input;          // the latest key press used that may not have been shown yet
+
+      // mode_gameplay
+    std::vector<SpriteInstance> sprites;    // objects that can move and are near the view, in drawing order
+    std::string hudText;        // only copied when hudVersion changes
+    long long   hudVersion;
+    double      cameraFromX;    // world position at the view's lower left, before and after the tick
+    double      cameraFromY;
+    double      cameraX;
+    double      cameraY;
+
+      // Objects that never move in a region around the view, drawn
+      // underneath the others.  Only refilled when the region or the
+      // objects in it change, as counted by staticVersion.
+    std::vector<SpriteInstance> staticSprites;
+    long long   staticVersion;
+
+      // mode_prompt
+    std::string mainMessage;
+    std::string secondMessage;
+};
+
+#endif // RENDERSNAPSHOT_H_
@@ -0,0 +1,646 @@
+#ifndef REWINDBUFFER_H_
+#define REWINDBUFFER_H_
+
+#include "RewindState.h"
+#include "AssetPack.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+  // Turns a series of states into bytes and back.  A keyframe is a whole
+  // state; after it, each state records only what it didn't change the
+  // way the one before last did.  An object walking along (or doing
+  // anything else that repeats every tick or every other tick) costs
+  // nothing, and one that turns costs a few bytes.  One coder does either
+  // the writing or the reading of a series, and remembers where it has
+  // got to.  Values may be any int, so the arithmetic on them is done on
+  // their bits as std::uint32_t, where it wraps around and comes back
+  // exactly.
+class RewindCoder
+{
+  public:
+    void writeKeyframe(std::vector<char>& out, const RewindState& state)
+    {
+        m_header[0] = static_cast<std::uint32_t>(state.score);
+        for (int k = 0; k < RewindState::NUM_WORLD_VALUES; k++)
+            m_header[1 + k] = static_cast<std::uint32_t>(state.worldValues[k]);
+        for (int k = 0; k < NUM_HEADER_FIELDS; k++)
+            putSigned(out, m_header[k]);
+
+        putVarint(out, static_cast<std::uint32_t>(state.objects.size()));
+        m_objects.resize(state.objects.size());
+        unsigned int lastID = 0;
+        for (size_t n = 0; n < state.objects.size(); n++)
+        {
+            Tracked& t = m_objects[n];
+            toFields(state.objects[n], t);
+            startTracking(t);
+            putVarint(out, t.id - lastID);
+            lastID = t.id;
+            for (int k = 0; k < NUM_FIELDS; k++)
+                putSigned(out, t.field[k]);
+        }
+    }
+
+      // A state's record after a keyframe: the world fields that changed
+      // (a mask, then the changes), then each object added, removed, or
+      // changed other than as predicted, in ID order (the ID's distance
+      // from the last one, its flags, and its fields, or how far they are
+      // from the prediction)
+    void writeDelta(std::vector<char>& out, const RewindState& state)
+    {
+        std::uint32_t header[NUM_HEADER_FIELDS];
+        header[0] = static_cast<std::uint32_t>(state.score);
+        for (int k = 0; k < RewindState::NUM_WORLD_VALUES; k++)
+            header[1 + k] = static_cast<std::uint32_t>(state.worldValues[k]);
+        std::uint32_t headerMask = 0;
+        for (int k = 0; k < NUM_HEADER_FIELDS; k++)
+        {
+            if (header[k] != m_header[k])
+                headerMask |= 1u << k;
+        }
+        putVarint(out, headerMask);
+        for (int k = 0; k < NUM_HEADER_FIELDS; k++)
+        {
+            if (headerMask & (1u << k))
+                putSigned(out, header[k] - m_header[k]);
+            m_header[k] = header[k];
+        }
+
+        const std::vector<Tracked>& prev = m_objects;
+        std::vector<Tracked>& next = m_next;
+        next.resize(state.objects.size());
+        m_entries.clear();
+        std::uint32_t numEntries = 0;
+        unsigned int lastID = 0;
+        size_t p = 0;
+        for (size_t n = 0; n < state.objects.size()  ||  p < prev.size(); )
+        {
+            if (n == state.objects.size()  ||  (p < prev.size()  &&  prev[p].id < state.objects[n].id))
+            {
+                putVarint(m_entries, prev[p].id - lastID);
+                putVarint(m_entries, REMOVED);
+                lastID = prev[p].id;
+                numEntries++;
+                p++;
+                continue;
+            }
+
+            Tracked& t = next[n];
+            toFields(state.objects[n], t);
+            if (p == prev.size()  ||  prev[p].id > t.id)
+            {
+                startTracking(t);
+                putVarint(m_entries, t.id - lastID);
+                putVarint(m_entries, ADDED);
+                for (int k = 0; k < NUM_FIELDS; k++)
+                    putSigned(m_entries, t.field[k]);
+                lastID = t.id;
+                numEntries++;
+                n++;
+                continue;
+            }
+
+            const Tracked& old = prev[p];
+            std::uint32_t mask = 0;
+            for (int k = 0; k < NUM_FIELDS; k++)
+            {
+                if (t.field[k] != old.field[k] + old.delta2[k])
+                    mask |= 1u << k;
+            }
+            if (mask != 0)
+            {
+                putVarint(m_entries, t.id - lastID);
+                putVarint(m_entries, mask);
+                for (int k = 0; k < NUM_FIELDS; k++)
+                {
+                    if (mask & (1u << k))
+                        putSigned(m_entries, t.field[k] - (old.field[k] + old.delta2[k]));
+                }
+                lastID = t.id;
+                numEntries++;
+            }
+            track(old, t);
+            n++;
+            p++;
+        }
+        putVarint(out, numEntries);
+        out.insert(out.end(), m_entries.begin(), m_entries.end());
+        m_objects.swap(next);
+    }
+
+    bool readKeyframe(const char*& p, const char* end)
+    {
+        for (int k = 0; k < NUM_HEADER_FIELDS; k++)
+        {
+            if (!getSigned(p, end, m_header[k]))
+                return false;
+        }
+        std::uint32_t count;
+        if (!getVarint(p, end, count)  ||  count > static_cast<std::uint32_t>(end - p))
+            return false;
+        m_objects.resize(count);
+        unsigned int id = 0;
+        for (Tracked& t : m_objects)
+        {
+            std::uint32_t gap;
+            if (!getVarint(p, end, gap))
+                return false;
+            id += gap;
+            t.id = id;
+            for (int k = 0; k < NUM_FIELDS; k++)
+            {
+                if (!getSigned(p, end, t.field[k]))
+                    return false;
+            }
+            startTracking(t);
+        }
+        return true;
+    }
+
+    bool readDelta(const char*& p, const char* end)
+    {
+        std::uint32_t headerMask;
+        if (!getVarint(p, end, headerMask))
+            return false;
+        for (int k = 0; k < NUM_HEADER_FIELDS; k++)
+        {
+            std::uint32_t change;
+            if (headerMask & (1u << k))
+            {
+                if (!getSigned(p, end, change))
+                    return false;
+                m_header[k] += change;
+            }
+        }
+
+        std::uint32_t numEntries;
+        if (!getVarint(p, end, numEntries))
+            return false;
+        const std::vector<Tracked>& prev = m_objects;
+        std::vector<Tracked>& next = m_next;
+        next.clear();
+        size_t n = 0;
+        unsigned int id = 0;
+        for (std::uint32_t e = 0; e <= numEntries; e++)
+        {
+            std::uint32_t gap = 0;
+            std::uint32_t flags = 0;
+            if (e < numEntries  &&  (!getVarint(p, end, gap)  ||  !getVarint(p, end, flags)))
+                return false;
+            id += gap;
+
+              // Objects up to the entry's changed as predicted
+            for ( ; n < prev.size()  &&  (e == numEntries  ||  prev[n].id < id); n++)
+            {
+                next.push_back(prev[n]);
+                Tracked& t = next.back();
+                for (int k = 0; k < NUM_FIELDS; k++)
+                    t.field[k] += prev[n].delta2[k];
+                track(prev[n], t);
+            }
+            if (e == numEntries)
+                break;
+
+            if (flags == ADDED)
+            {
+                next.push_back(Tracked());
+                Tracked& t = next.back();
+                t.id = id;
+                for (int k = 0; k < NUM_FIELDS; k++)
+                {
+                    if (!getSigned(p, end, t.field[k]))
+                        return false;
+                }
+                startTracking(t);
+                continue;
+            }
+            if (n == prev.size()  ||  prev[n].id != id)
+                return false;
+            if (flags == REMOVED)
+            {
+                n++;
+                continue;
+            }
+            next.push_back(prev[n]);
+            Tracked& t = next.back();
+            for (int k = 0; k < NUM_FIELDS; k++)
+            {
+                std::uint32_t residual = 0;
+                if ((flags & (1u << k))  &&  !getSigned(p, end, residual))
+                    return false;
+                t.field[k] += prev[n].delta2[k] + residual;
+            }
+            track(prev[n], t);
+            n++;
+        }
+        m_objects.swap(next);
+        return true;
+    }
+
+      // The state last written or read, all but its tick
+    void getState(RewindState& state) const
+    {
+        state.score = static_cast<int>(m_header[0]);
+        for (int k = 0; k < RewindState::NUM_WORLD_VALUES; k++)
+            state.worldValues[k] = static_cast<int>(m_header[1 + k]);
+        state.objects.resize(m_objects.size());
+        for (size_t k = 0; k < m_objects.size(); k++)
+            fromFields(m_objects[k], state.objects[k]);
+    }
+
+    static void putVarint(std::vector<char>& out, std::uint32_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(static_cast<char>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+      // v is a signed value's bits; zigzag them so that small values
+      // either side of 0 take few bytes
+    static void putSigned(std::vector<char>& out, std::uint32_t v)
+    {
+        putVarint(out, (v << 1) ^ (0u - (v >> 31)));
+    }
+
+    static bool getVarint(const char*& p, const char* end, std::uint32_t& v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (p == end)
+                return false;
+            unsigned char c = static_cast<unsigned char>(*p++);
+            v |= static_cast<std::uint32_t>(c & 0x7f) << shift;
+            if (c < 0x80)
+                return true;
+        }
+        return false;
+    }
+
+    static bool getSigned(const char*& p, const char* end, std::uint32_t& v)
+    {
+        std::uint32_t u;
+        if (!getVarint(p, end, u))
+            return false;
+        v = (u >> 1) ^ (0u - (u & 1));
+        return true;
+    }
+
+  private:
+    static const int NUM_HEADER_FIELDS = 1 + RewindState::NUM_WORLD_VALUES;
+    static const int NUM_FIELDS = 4 + RewindObject::NUM_VALUES;
+
+      // Flags of an object in a state's record beyond a bit per field it
+      // didn't change as predicted
+    static const std::uint32_t ADDED = 1u << NUM_FIELDS;
+    static const std::uint32_t REMOVED = 1u << (NUM_FIELDS + 1);
+
+    struct Tracked
+    {
+        unsigned int  id;
+        std::uint32_t field[NUM_FIELDS];    // kind, x, y, direction, values
+        std::uint32_t delta[NUM_FIELDS];    // change in the latest state
+        std::uint32_t delta2[NUM_FIELDS];   // change in the one before; the next one's prediction
+    };
+
+    std::uint32_t        m_header[NUM_HEADER_FIELDS];    // score, world values
+    std::vector<Tracked> m_objects;
+    std::vector<Tracked> m_next;        // scratch for the next state's
+    std::vector<char>    m_entries;     // scratch for a state's objects
+
+    static void toFields(const RewindObject& o, Tracked& t)
+    {
+        t.id = o.id;
+        t.field[0] = static_cast<std::uint32_t>(o.kind);
+        t.field[1] = static_cast<std::uint32_t>(o.x);
+        t.field[2] = static_cast<std::uint32_t>(o.y);
+        t.field[3] = static_cast<std::uint32_t>(o.direction);
+        for (int k = 0; k < RewindObject::NUM_VALUES; k++)
+            t.field[4 + k] = static_cast<std::uint32_t>(o.values[k]);
+    }
+
+    static void fromFields(const Tracked& t, RewindObject& o)
+    {
+        o.id = t.id;
+        o.kind = static_cast<int>(t.field[0]);
+        o.x = static_cast<int>(t.field[1]);
+        o.y = static_cast<int>(t.field[2]);
+        o.direction = static_cast<int>(t.field[3]);
+        for (int k = 0; k < RewindObject::NUM_VALUES; k++)
+            o.values[k] = static_cast<int>(t.field[4 + k]);
+    }
+
+    static void startTracking(Tracked& t)
+    {
+        for (int k = 0; k < NUM_FIELDS; k++)
+            t.delta[k] = t.delta2[k] = 0;
+    }
+
+      // next follows prev by whatever changes are in next.field
+    static void track(const Tracked& prev, Tracked& next)
+    {
+        for (int k = 0; k < NUM_FIELDS; k++)
+        {
+            next.delta2[k] = prev.delta[k];
+            next.delta[k] = next.field[k] - prev.field[k];
+        }
+    }
+};
+
+  // The states after a run of consecutive ticks, in at most about budget
+  // bytes; once that fills up, the oldest are forgotten.  The ticks are
+  // kept in blocks of KEYFRAME_INTERVAL, each a keyframe and then the
+  // changes from it as a RewindCoder writes them.  Full blocks are then
+  // compressed with AssetCompression.  Getting a state back means decoding
+  // its block from the start, at most KEYFRAME_INTERVAL ticks, which keeps
+  // a step backward to a few milliseconds even with a thousand actors.
+  // The shipped levels take at most about 35 bytes a tick, so the default
+  // budget holds an hour of any of them.
+  //
+  // record() runs every tick, so it allocates only while its scratch is
+  // still growing to fit: the block being written goes into one buffer
+  // that keeps its size, sealed blocks go one after another into a store
+  // of budget bytes made up front, each overwriting the oldest, and the
+  // ring of blocks grows only when it holds more of them than ever before.
+class RewindBuffer
+{
+  public:
+    static const int KEYFRAME_INTERVAL = 64;
+    static const size_t DEFAULT_BUDGET = 8 << 20;
+
+    explicit RewindBuffer(size_t budget = DEFAULT_BUDGET)
+     : m_store(budget), m_storeEnd(0), m_firstBlock(0), m_numBlocks(0), m_decodedTick(-1)
+    {}
+
+    void clear()
+    {
+        m_storeEnd = 0;
+        m_numBlocks = 0;
+        m_decodedTick = -1;
+    }
+
+    bool empty() const
+    {
+        return m_numBlocks == 0;
+    }
+
+    long long firstTick() const
+    {
+        return empty() ? 0 : block(0).firstTick;
+    }
+
+    long long lastTick() const
+    {
+        return empty() ? -1 : lastBlock().firstTick + lastBlock().numTicks - 1;
+    }
+
+    size_t bytesUsed() const
+    {
+        size_t n = 0;
+        for (size_t k = 0; k < m_numBlocks; k++)
+            n += (block(k).sealed ? block(k).storedSize : m_open.size());
+        return n;
+    }
+
+      // Add the state after the tick following lastTick(); a state for any
+      // other tick starts the buffer over
+    void record(const RewindState& state)
+    {
+        if (empty()  ||  state.tick != lastTick() + 1)
+            clear();
+        if (empty()  ||  lastBlock().numTicks == KEYFRAME_INTERVAL)
+            startBlock(state.tick);
+
+        Block& b = lastBlock();
+        if (b.numTicks == 0)
+            m_encoder.writeKeyframe(m_open, state);
+        else
+            m_encoder.writeDelta(m_open, state);
+        b.numTicks++;
+    }
+
+      // Put the state after tick into state; false if it isn't kept.
+      // Decoding goes on from the last tick sought if that was earlier in
+      // the same block, so stepping forward costs one tick's record.
+    bool seek(long long tick, RewindState& state)
+    {
+        const Block* b = findBlock(tick);
+        if (b == nullptr)
+            return false;
+        if (m_decodedTick < 0  ||  m_decodedBlockTick != b->firstTick  ||  tick < m_decodedTick)
+        {
+            m_decodedTick = -1;
+            if (b->sealed)
+            {
+                m_raw.resize(b->rawSize);
+                if (!AssetCompression::decompress(&m_store[b->offset], b->storedSize, m_raw.data(), m_raw.size()))
+                    return false;
+            }
+            const std::vector<char>& data = (b->sealed ? m_raw : m_open);
+            const char* p = data.data();
+            if (!m_decoder.readKeyframe(p, data.data() + data.size()))
+                return false;
+            m_decodedBlockTick = b->firstTick;
+            m_decodedTick = b->firstTick;
+            m_decodedOffset = p - data.data();
+        }
+
+        const std::vector<char>& data = (b->sealed ? m_raw : m_open);
+        const char* p = data.data() + m_decodedOffset;
+        for ( ; m_decodedTick < tick; m_decodedTick++)
+        {
+            if (!m_decoder.readDelta(p, data.data() + data.size()))
+            {
+                m_decodedTick = -1;
+                return false;
+            }
+        }
+        m_decodedOffset = p - data.data();
+        m_decoder.getState(state);
+        state.tick = tick;
+        return true;
+    }
+
+      // Forget the ticks after tick, so that the next one recorded can be
+      // tick + 1
+    void truncateAfter(long long tick)
+    {
+        if (tick >= lastTick())
+            return;
+        m_decodedTick = -1;
+        if (tick < firstTick())
+        {
+            clear();
+            return;
+        }
+        while (lastBlock().firstTick > tick)
+            m_numBlocks--;
+
+          // Go on adding to the block holding tick, from just after it
+        Block& b = lastBlock();
+        if (b.sealed)
+        {
+            m_open.resize(b.rawSize);
+            if (!AssetCompression::decompress(&m_store[b.offset], b.storedSize, m_open.data(), m_open.size()))
+            {
+                clear();
+                return;
+            }
+            b.sealed = false;
+            m_storeEnd = b.offset;
+        }
+        size_t end;
+        if (!decodeBlock(b, m_open, tick, m_encoder, &end))
+        {
+            clear();
+            return;
+        }
+        m_open.resize(end);
+        b.numTicks = static_cast<int>(tick - b.firstTick + 1);
+    }
+
+    RewindBuffer(const RewindBuffer&) = delete;
+    RewindBuffer& operator=(const RewindBuffer&) = delete;
+
+  private:
+      // Only the last block is unsealed, and its bytes are in m_open
+    struct Block
+    {
+        long long firstTick;
+        int       numTicks;
+        bool      sealed;       // compressed from rawSize bytes into storedSize at offset in m_store
+        size_t    rawSize;
+        size_t    offset;
+        size_t    storedSize;
+    };
+
+      // Sealed blocks are in m_store in the order they were sealed, the
+      // newest ending at m_storeEnd; when one doesn't fit before the end,
+      // it goes at the start.  Either way, the oldest blocks in its way
+      // are forgotten.
+    std::vector<char>   m_store;
+    size_t              m_storeEnd;
+    std::vector<Block>  m_blocks;       // a ring; the oldest at m_firstBlock
+    size_t              m_firstBlock;
+    size_t              m_numBlocks;
+    std::vector<char>   m_open;         // the last block's bytes
+    RewindCoder         m_encoder;
+    std::vector<char>   m_compressed;   // scratch for sealing a block
+    std::vector<int>    m_compressTable;
+
+      // Where seek() has decoded to: m_decoder holds the state after
+      // m_decodedTick (-1 if none), whose record in the block starting at
+      // m_decodedBlockTick ends at m_decodedOffset.  A sealed block's
+      // bytes are decompressed into m_raw.
+    RewindCoder       m_decoder;
+    long long         m_decodedBlockTick;
+    long long         m_decodedTick;
+    size_t            m_decodedOffset;
+    std::vector<char> m_raw;
+
+    Block& block(size_t k)
+    {
+        return m_blocks[(m_firstBlock + k) % m_blocks.size()];
+    }
+
+    const Block& block(size_t k) const
+    {
+        return m_blocks[(m_firstBlock + k) % m_blocks.size()];
+    }
+
+    Block& lastBlock()
+    {
+        return block(m_numBlocks - 1);
+    }
+
+    const Block& lastBlock() const
+    {
+        return block(m_numBlocks - 1);
+    }
+
+    void startBlock(long long tick)
+    {
+        if (!empty()  &&  !lastBlock().sealed)
+        {
+            m_decodedTick = -1;     // the block it may be in is about to change form
+            AssetCompression::compress(m_open.data(), m_open.size(), m_compressed, m_compressTable);
+            size_t size = m_compressed.size();
+            if (size > m_store.size())
+            {
+                forgetSealedBlocks(m_store.size());
+                m_store.resize(size);
+            }
+            if (m_storeEnd + size > m_store.size())
+            {
+                  // What's after the newest block is older than what's before it
+                forgetSealedBlocks(m_store.size());
+                m_storeEnd = 0;
+            }
+            forgetSealedBlocks(m_storeEnd + size);
+            std::copy(m_compressed.begin(), m_compressed.end(), m_store.begin() + m_storeEnd);
+
+            Block& last = lastBlock();
+            last.rawSize = m_open.size();
+            last.offset = m_storeEnd;
+            last.storedSize = size;
+            last.sealed = true;
+            m_storeEnd += size;
+            m_open.clear();
+        }
+
+          // A full ring grows with its oldest block moved to the front
+        if (m_numBlocks == m_blocks.size())
+        {
+            std::rotate(m_blocks.begin(), m_blocks.begin() + m_firstBlock, m_blocks.end());
+            m_firstBlock = 0;
+            m_blocks.emplace_back();
+        }
+        block(m_numBlocks++) = Block{ tick, 0, false, 0, 0, 0 };
+        m_open.clear();
+    }
+
+      // Forget the oldest sealed blocks from m_storeEnd up to end in m_store
+    void forgetSealedBlocks(size_t end)
+    {
+        while (m_numBlocks > 1  &&  block(0).offset >= m_storeEnd  &&  block(0).offset < end)
+        {
+            m_firstBlock = (m_firstBlock + 1) % m_blocks.size();
+            m_numBlocks--;
+        }
+    }
+
+    const Block* findBlock(long long tick) const
+    {
+        if (tick < firstTick()  ||  tick > lastTick())
+            return nullptr;
+        size_t k = static_cast<size_t>((tick - firstTick()) / KEYFRAME_INTERVAL);
+        return &block(k);       // every block but the last is full
+    }
+
+      // Decode unsealed block b, whose bytes are data, up to tick into c,
+      // and say where tick's record ends
+    static bool decodeBlock(const Block& b, const std::vector<char>& data, long long tick,
+                            RewindCoder& c, size_t* end)
+    {
+        const char* p = data.data();
+        const char* dataEnd = data.data() + data.size();
+        if (!c.readKeyframe(p, dataEnd))
+            return false;
+        for (long long t = b.firstTick + 1; t <= tick; t++)
+        {
+            if (!c.readDelta(p, dataEnd))
+                return false;
+        }
+        if (end != nullptr)
+            *end = p - data.data();
+        return true;
+    }
+};
+
+#endif // REWINDBUFFER_H_
@@ -0,0 +1,33 @@
+#ifndef REWINDSTATE_H_
+#define REWINDSTATE_H_
+
+#include <vector>
+
+  // One object's state as the rewind buffer keeps it: an ID that stays the
+  // same for the object's whole life, what kind of object it is and where
+  // it is (whatever the world means by those), and up to NUM_VALUES more
+  // numbers of the world's choosing.  Positions are whole numbers.
+struct RewindObject
+{
+    static const int NUM_VALUES = 6;
+
+    unsigned int id;
+    int          kind;
+    int          x;
+    int          y;
+    int          direction;
+    int          values[NUM_VALUES];
+};
+
+  // The world as it was after one tick
+struct RewindState
+{
+    static const int NUM_WORLD_VALUES = 8;
+
+    long long                 tick;
+    int                       score;
+    int                       worldValues[NUM_WORLD_VALUES];
+    std::vector<RewindObject> objects;      // in increasing ID order
+};
+
+#endif // REWINDSTATE_H_
@@ -1,103 +1,255 @@
 #ifndef SOUNDFX_H_
 #define SOUNDFX_H_
 
+#include "AudioMixer.h"
+#include "AssetPack.h"
+#include <iostream>
 #include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+
+  // Sound effects are decoded into PCM once, when they are loaded, and
+  // mixed in this process by an AudioMixer.  Where the audio goes depends on
+  // the platform: the waveOut API on Windows, an AudioQueue on macOS (link
+  // with the AudioToolbox framework), and nowhere elsewhere.  start() can
+  // be given another sink instead, e.g. a WavFileAudioSink to record it.
 
 #if defined(_MSC_VER)
 
-#include "irrKlang/irrKlang.h"
-#pragma comment(lib, "irrKlang.lib")
-#include <iostream>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
 
-class SoundFXController
+class DeviceAudioSink : public AudioSink
 {
   public:
-
-    void playClip(std::string soundFile)
+    DeviceAudioSink()
+     : m_device(nullptr), m_next(0)
     {
-        if (m_engine != nullptr)
-            m_engine->play2D(soundFile.c_str(), false);
+        m_bufferDone = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        WAVEFORMATEX format = {};
+        format.wFormatTag = WAVE_FORMAT_PCM;
+        format.nChannels = AUDIO_CHANNELS;
+        format.nSamplesPerSec = AUDIO_SAMPLE_RATE;
+        format.wBitsPerSample = 16;
+        format.nBlockAlign = AUDIO_CHANNELS * sizeof(std::int16_t);
+        format.nAvgBytesPerSec = AUDIO_SAMPLE_RATE * format.nBlockAlign;
+        if (waveOutOpen(&m_device, WAVE_MAPPER, &format, reinterpret_cast<DWORD_PTR>(m_bufferDone), 0,
+                        CALLBACK_EVENT) != MMSYSERR_NOERROR)
+            m_device = nullptr;
+        for (WAVEHDR& h : m_headers)
+            h = WAVEHDR{};
     }
 
-    void abortClip()
+    ~DeviceAudioSink()
     {
-        if (m_engine != nullptr)
-            m_engine->stopAllSounds();
+        if (m_device != nullptr)
+        {
+            waveOutReset(m_device);
+            for (WAVEHDR& h : m_headers)
+            {
+                if (h.dwFlags & WHDR_PREPARED)
+                    waveOutUnprepareHeader(m_device, &h, sizeof(h));
+            }
+            waveOutClose(m_device);
+        }
+        CloseHandle(m_bufferDone);
     }
 
-    static SoundFXController& getInstance();
-
-  private:
-    irrklang::ISoundEngine* m_engine;
-
-    SoundFXController()
+    bool isOpen() const
     {
-        m_engine = irrklang::createIrrKlangDevice();
-        if (m_engine == nullptr)
-            std::cout << "Cannot create sound engine!  Game will be silent."
-                      << std::endl;
+        return m_device != nullptr;
     }
 
-    ~SoundFXController()
+    virtual void write(const std::int16_t* samples, size_t frames)
     {
-        if (m_engine != nullptr)
-            m_engine->drop();
+          // Wait for the device to finish with the oldest buffer, then
+          // refill it and queue it again
+        WAVEHDR& h = m_headers[m_next];
+        while (h.dwFlags & WHDR_INQUEUE)
+            WaitForSingleObject(m_bufferDone, INFINITE);
+        if (h.dwFlags & WHDR_PREPARED)
+            waveOutUnprepareHeader(m_device, &h, sizeof(h));
+
+        std::vector<std::int16_t>& buffer = m_buffers[m_next];
+        buffer.assign(samples, samples + frames * AUDIO_CHANNELS);
+        h = WAVEHDR{};
+        h.lpData = reinterpret_cast<LPSTR>(buffer.data());
+        h.dwBufferLength = static_cast<DWORD>(buffer.size() * sizeof(std::int16_t));
+        waveOutPrepareHeader(m_device, &h, sizeof(h));
+        waveOutWrite(m_device, &h, sizeof(h));
+        m_next = (m_next + 1) % NUM_BUFFERS;
     }
 
-    SoundFXController(const SoundFXController&);
-    SoundFXController& operator=(const SoundFXController&);
+  private:
+    static const int NUM_BUFFERS = 8;
+
+    HWAVEOUT                  m_device;
+    HANDLE                    m_bufferDone;     // signaled as the device finishes each buffer
+    WAVEHDR                   m_headers[NUM_BUFFERS];
+    std::vector<std::int16_t> m_buffers[NUM_BUFFERS];
+    int                       m_next;           // the buffer to fill next
 };
 
 #elif defined(__APPLE__)
 
-#include <memory>
-#include <spawn.h>
-#include <csignal>
-#include <cstring>
+#include <AudioToolbox/AudioToolbox.h>
+#include <mutex>
+#include <condition_variable>
 
-class SoundFXController
+class DeviceAudioSink : public AudioSink
 {
   public:
-    SoundFXController()
-     : pidValid(false)
-    {}
+    DeviceAudioSink()
+     : m_queue(nullptr)
+    {
+        AudioStreamBasicDescription format = {};
+        format.mSampleRate = AUDIO_SAMPLE_RATE;
+        format.mFormatID = kAudioFormatLinearPCM;
+        format.mFormatFlags = kLinearPCMFormatFlagIsSignedInteger | kLinearPCMFormatFlagIsPacked;
+        format.mBytesPerPacket = AUDIO_CHANNELS * sizeof(std::int16_t);
+        format.mFramesPerPacket = 1;
+        format.mBytesPerFrame = AUDIO_CHANNELS * sizeof(std::int16_t);
+        format.mChannelsPerFrame = AUDIO_CHANNELS;
+        format.mBitsPerChannel = 16;
+        if (AudioQueueNewOutput(&format, bufferDone, this, nullptr, nullptr, 0, &m_queue) != noErr)
+        {
+            m_queue = nullptr;
+            return;
+        }
+        for (int k = 0; k < NUM_BUFFERS; k++)
+        {
+            AudioQueueBufferRef buffer;
+            if (AudioQueueAllocateBuffer(m_queue, AudioMixer::BLOCK_FRAMES * format.mBytesPerFrame, &buffer) == noErr)
+                m_free.push_back(buffer);
+        }
+        AudioQueueStart(m_queue, nullptr);
+    }
 
-    void playClip(std::string soundFile)
+    ~DeviceAudioSink()
     {
-        char cmd[] = "/usr/bin/afplay";
-        std::unique_ptr<char[]> fileName(new char[soundFile.size()+1]);
-        std::strcpy(fileName.get(), soundFile.c_str());
-        char* argv[] = { cmd, fileName.get(), nullptr };
-        abortClip();  // stop anything currently playing
-        pidValid = (posix_spawn(&pid, argv[0], nullptr, nullptr, argv, nullptr) == 0);
+        if (m_queue != nullptr)
+        {
+            AudioQueueStop(m_queue, true);
+            AudioQueueDispose(m_queue, true);
+        }
     }
-    
-    void abortClip()
+
+    bool isOpen() const
     {
-        if (pidValid)
-            kill(pid, SIGINT);
-        pidValid = false;
+        return m_queue != nullptr  &&  !m_free.empty();
+    }
+
+    virtual void write(const std::int16_t* samples, size_t frames)
+    {
+        AudioQueueBufferRef buffer;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_bufferFreed.wait(lock, [this]() { return !m_free.empty(); });
+            buffer = m_free.back();
+            m_free.pop_back();
+        }
+        UInt32 bytes = static_cast<UInt32>(std::min<size_t>(frames * AUDIO_CHANNELS * sizeof(std::int16_t),
+                                                           buffer->mAudioDataBytesCapacity));
+        std::memcpy(buffer->mAudioData, samples, bytes);
+        buffer->mAudioDataByteSize = bytes;
+        AudioQueueEnqueueBuffer(m_queue, buffer, 0, nullptr);
     }
-    
-    static SoundFXController& getInstance();
 
   private:
-    pid_t pid;
-    bool pidValid;
+    static const int NUM_BUFFERS = 8;
+
+    AudioQueueRef                    m_queue;
+    std::vector<AudioQueueBufferRef> m_free;    // buffers the queue has finished playing
+    std::mutex                       m_mutex;
+    std::condition_variable          m_bufferFreed;
+
+      // Called on the AudioQueue's own thread
+    static void bufferDone(void* userData, AudioQueueRef, AudioQueueBufferRef buffer)
+    {
+        DeviceAudioSink* sink = static_cast<DeviceAudioSink*>(userData);
+        std::lock_guard<std::mutex> lock(sink->m_mutex);
+        sink->m_free.push_back(buffer);
+        sink->m_bufferFreed.notify_one();
+    }
 };
 
-#else  // forget about sound
+#else  // no sound device backend
 
-class SoundFXController
+class DeviceAudioSink : public NullAudioSink
 {
   public:
-    void playClip(std::string) {}
-    void abortClip() {}
-    static SoundFXController& getInstance();
+    bool isOpen() const
+    {
+        return false;
+    }
 };
 
 #endif
 
+class SoundFXController
+{
+  public:
+      // Load the WAV files (which may be in the asset pack) as clips 0, 1,
+      // 2, ... in order and start mixing into sink, or into the sound
+      // device if sink is null.  Without a working device, the audio is
+      // mixed and thrown away.  The files are decoded on the audio thread,
+      // so this returns at once; clips played before then start late.  A
+      // clip that can't be loaded is reported and plays as silence.
+    void start(std::vector<std::string> soundFiles, std::unique_ptr<AudioSink> sink = nullptr)
+    {
+        if (sink == nullptr)
+        {
+            std::unique_ptr<DeviceAudioSink> device(new DeviceAudioSink);
+            if (device->isOpen())
+                sink = std::move(device);
+            else
+                sink.reset(new NullAudioSink);
+        }
+        m_mixer.start(std::move(sink), [this, soundFiles]()
+        {
+            for (const std::string& soundFile : soundFiles)
+            {
+                AssetData file;
+                std::vector<std::int16_t> samples;
+                if (!Assets().read(soundFile, file)  ||  !WavDecoder::decode(file.data(), file.size(), samples))
+                    std::cerr << "Cannot load sound " << soundFile << std::endl;
+                m_mixer.addClip(std::move(samples));
+            }
+        });
+    }
+
+    void stop()
+    {
+        m_mixer.stop();
+    }
+
+      // These two never wait; call them only from the simulation thread
+    void playClip(int clipID, int priority = 0)
+    {
+        m_mixer.play(clipID, priority);
+    }
+
+    void abortClip()
+    {
+        m_mixer.stopAll();
+    }
+
+    static SoundFXController& getInstance();
+
+  private:
+    AudioMixer m_mixer;
+
+    SoundFXController() {}
+    SoundFXController(const SoundFXController&) = delete;
+    SoundFXController& operator=(const SoundFXController&) = delete;
+};
+
   // Meyers singleton pattern
 inline SoundFXController& SoundFXController::getInstance()
 {
@@ -3,21 +3,27 @@
 
 #include "freeglut.h"
 
-#ifndef GL_BGR
-#define GL_BGR GL_BGR_EXT
-#endif
-
 #ifndef GL_BGRA
 #define GL_BGRA GL_BGRA_EXT
 #endif
 
 #include "GameConstants.h"
+#include "PerfCounters.h"
+#include "RenderQueue.h"
+#include "AssetPack.h"
+#include "TgaDecoder.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <map>
+#include <vector>
 #include <memory>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstring>
+#include <cstdint>
 
 static const double VISIBLE_MIN_X = -2.39;
 static const double VISIBLE_MAX_X = 2.39;
@@ -31,189 +37,326 @@ class SpriteManager
 public:
 
     SpriteManager()
-     : m_mipMapped(true)
+     : m_mipMapped(true), m_loadSucceeded(true), m_atlasDirty(false), m_staticList(0), m_staticLayerValid(false),
+       m_staticLayerSprites(0), m_staticLayerBinds(0), m_staticLayerDraws(0), m_staticLayerLastPage(-1),
+       m_cameraX(0), m_cameraY(0)
     {
+        buildOrientations();
     }
 
+      // Sprites load in the background.  loadSprite() only notes which file
+      // holds a frame.  startLoading() then decodes every noted file on
+      // worker threads, packs the frames into the atlas, and builds its
+      // mipmaps, all without OpenGL; finishLoading() waits for that and says
+      // whether every file loaded.  beginBatch() and beginStaticLayer()
+      // finish loading (starting it first if need be), so only the uploads
+      // happen on the OpenGL thread, and only once something is drawn.
+      // Until loading finishes, only getNumFrames() may be called.
+
     bool loadSprite(std::string filename_tga, int imageID, int frameNum)
     {
-          // Load Texture Data From TGA File
-
         int spriteID = getSpriteID(imageID, frameNum);
         if (spriteID == INVALID_SPRITE_ID)
             return false;
 
         m_frameCountPerSprite[imageID]++;   // keep track of how many frames per sprite we loaded
+        m_pendingFrames.push_back(PendingFrame{ filename_tga, spriteID });
+        return true;
+    }
 
-        std::ifstream tgaFile(filename_tga, std::ios::in|std::ios::binary);
-        if (!tgaFile)
-            return false;
+      // Keep the finished atlas (every page's pixels and mipmaps, ready to
+      // upload) in filename, so that later runs loading the same files skip
+      // building it.  The cache is keyed by a hash of the files' contents,
+      // so it is rebuilt whenever any of them changes.  Call this before
+      // loading starts; with no cache file (the default), nothing is cached.
+    void setTextureCache(std::string filename)
+    {
+        m_cacheFile = filename;
+    }
 
-        char type[3];
-        char info[6];
-
-          // Read file header info
-        tgaFile.read(type, 3);
-        tgaFile.seekg(12);
-        tgaFile.read(info, 6);
-        unsigned int textureWidth = static_cast<unsigned char>(info[0]) + static_cast<unsigned char>(info[1]) * 256;
-        unsigned int textureHeight = static_cast<unsigned char>(info[2]) + static_cast<unsigned char>(info[3]) * 256;
-        unsigned char byteCount = static_cast<unsigned char>(info[4]) / 8;
-        long imageSize = textureWidth * textureHeight * byteCount;
-        std::unique_ptr<char[]> imageData(new char[imageSize]);
-        tgaFile.seekg(18);
-          // Read image data
-        tgaFile.read(imageData.get(), imageSize);
-        if (!tgaFile)
-            return false;
+    void startLoading()
+    {
+        if (m_pendingFrames.empty()  ||  m_loader.joinable())
+            return;
 
-          //image type either 2 (color) or 3 (greyscale)
-        if (type[1] != 0 || (type[2] != 2 && type[2] != 3))
-            return false;
+        std::vector<PendingFrame> frames;
+        frames.swap(m_pendingFrames);
+        m_loader = std::thread(&SpriteManager::loadFrames, this, std::move(frames));
+    }
 
-        if (byteCount != 3 && byteCount != 4)
-            return false;
+    bool finishLoading()
+    {
+        if (m_loader.joinable())
+            m_loader.join();
+        if (!m_pendingFrames.empty())   // noted since loading last started
+        {
+            startLoading();
+            m_loader.join();
+        }
+        return m_loadSucceeded;
+    }
 
-          // Transfer Texture To OpenGL
+    int getNumFrames(int imageID) const
+    {
+        auto it = m_frameCountPerSprite.find(imageID);
+        if (it == m_frameCountPerSprite.end())
+            return 0;
 
-        glEnable(GL_DEPTH_TEST);
+        return it->second;
+    }
 
-          // allocate a texture handle
-        GLuint glTextureID;
-        glGenTextures(1, &glTextureID);
+      // Sprites are drawn in batches: call beginBatch(), addSprite() for
+      // each sprite, then drawBatch().  Sprites go into a render queue that
+      // orders them back to front by depth and groups those on the same
+      // atlas page, so the batch goes to OpenGL as one vertex array with one
+      // texture bind and one draw call per run of sprites sharing a page.
+      // Sprites of equal depth are grouped by page and then by image; those
+      // with the same image stay in the order they were added.
+
+    void beginBatch()
+    {
+        finishLoading();
+        if (m_atlasDirty)
+            uploadAtlas();
+        m_queue.clear();
+        m_queuedSprites.clear();
+    }
 
-          // bind our new texture
-        glBindTexture(GL_TEXTURE_2D, glTextureID);
+    bool addSprite(int imageID, int frame, double x, double y, int angleDegrees, double size, int depth = 0)
+    {
+        if (!queueSprite(m_queue, m_queuedSprites, imageID, frame, x, y, angleDegrees, size, depth))
+            return false;
+        Perf().spriteDrawn();
+        return true;
+    }
 
-        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+      // Draw the static layer, if any, and then the batch on top of it
+    void drawBatch()
+    {
+        bool drawStatic = m_staticLayerValid  &&  m_staticLayerSprites != 0;
+        if (!drawStatic  &&  m_queue.empty())
+            return;
 
-        if (m_mipMapped)
+        beginSpriteState();
+        int boundPage = -1;
+        if (drawStatic)
         {
-              // when texture area is small, bilinear filter the closest mipmap
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-              // when texture area is large, bilinear filter the first mipmap
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glCallList(m_staticList);
+            Perf().textureBound(m_staticLayerBinds);
+            Perf().drawCallIssued(m_staticLayerDraws);
+            boundPage = m_staticLayerLastPage;
         }
-        else
+        if (!m_queue.empty())
         {
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            buildVertices(m_queue, m_queuedSprites, m_vertices);
+            int binds = 0;
+            int draws = 0;
+            submitRuns(m_queue, m_vertices, boundPage, binds, draws);
+            Perf().textureBound(binds);
+            Perf().drawCallIssued(draws);
         }
+        endSpriteState();
+    }
 
-          // Have the texture wrap both vertically and horizontally.
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLfloat>(GL_REPEAT));
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLfloat>(GL_REPEAT));
+      // The world position shown at the lower left of the view.  Sprites
+      // and the static layer are positioned in world coordinates; the
+      // camera offset is applied when they are drawn.
+    void setCamera(double x, double y)
+    {
+        m_cameraX = x;
+        m_cameraY = y;
+    }
 
-        if (m_mipMapped)
-        {
-              // build our texture mipmaps
-              // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-            makeMipmaps(byteCount, textureWidth, textureHeight, imageData.get());
-        }
-        else
-        {
-              // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-            if (3 == byteCount)
-                glTexImage2D(GL_TEXTURE_2D, 0, 3, textureWidth, textureHeight, 0, GL_BGR, GL_UNSIGNED_BYTE, imageData.get());
-            else if (4 == byteCount)
-                glTexImage2D(GL_TEXTURE_2D, 0, 4, textureWidth, textureHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, imageData.get());
-        }
+      // Sprites that never move can be compiled once into a static layer,
+      // which drawBatch() draws underneath the batch.  Build it with
+      // beginStaticLayer(), addStaticSprite() for each sprite, then
+      // endStaticLayer().  The layer is invalidated (see hasStaticLayer())
+      // when the atlas changes.
 
-        m_imageMap[spriteID] = glTextureID;
+    void beginStaticLayer()
+    {
+        finishLoading();
+        if (m_atlasDirty)
+            uploadAtlas();
+        m_staticQueue.clear();
+        m_staticSprites.clear();
+    }
 
-        return true;
+    bool addStaticSprite(int imageID, int frame, double x, double y, int angleDegrees, double size, int depth = 0)
+    {
+        return queueSprite(m_staticQueue, m_staticSprites, imageID, frame, x, y, angleDegrees, size, depth);
     }
 
-    int getNumFrames(int imageID) const
+    void endStaticLayer()
     {
-        auto it = m_frameCountPerSprite.find(imageID);
-        if (it == m_frameCountPerSprite.end())
-            return 0;
+        if (m_staticList == 0)
+            m_staticList = glGenLists(1);
 
-        return it->second;
+        buildVertices(m_staticQueue, m_staticSprites, m_staticVertices);
+
+          // Client array state isn't compiled into a display list, but the
+          // vertices a draw call reads from the arrays are, and so are the
+          // texture binds between runs
+        m_staticLayerBinds = 0;
+        m_staticLayerDraws = 0;
+        m_staticLayerLastPage = -1;
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+        glNewList(m_staticList, GL_COMPILE);
+        if (!m_staticVertices.empty())
+            submitRuns(m_staticQueue, m_staticVertices, m_staticLayerLastPage, m_staticLayerBinds, m_staticLayerDraws);
+        glEndList();
+        glPopClientAttrib();
+
+        m_staticLayerSprites = static_cast<int>(m_staticQueue.size());
+        m_staticVertices.clear();
+        m_staticLayerValid = true;
     }
 
-    bool plotSprite(int imageID, int frame, double x, double y, int angleDegrees, double size)
+    bool hasStaticLayer() const
     {
-        int spriteID = getSpriteID(imageID, frame);
-        if (spriteID == INVALID_SPRITE_ID)
-            return false;
-
-        auto it = m_imageMap.find(spriteID);
-        if (it == m_imageMap.end())
-            return false;
+        return m_staticLayerValid;
+    }
 
-        glPushMatrix();
+      // The atlas page holding a loaded frame, or -1
+    int atlasPage(int imageID, int frame) const
+    {
+        int spriteID = getSpriteID(imageID, frame);
+        if (spriteID == INVALID_SPRITE_ID  ||  spriteID >= static_cast<int>(m_frameRects.size())  ||
+            !m_frameRects[spriteID].loaded)
+            return -1;
+        return m_frameRects[spriteID].page;
+    }
 
-        double finalWidth = SPRITE_WIDTH_GL * size;
-        double finalHeight = SPRITE_HEIGHT_GL * size;
+    ~SpriteManager()
+    {
+        if (m_loader.joinable())
+            m_loader.join();
+        for (const AtlasPage& page : m_pages)
+        {
+            if (page.texture != 0)
+                glDeleteTextures(1, &page.texture);
+        }
+        if (m_staticList != 0)
+            glDeleteLists(m_staticList, 1);
+    }
 
-        // object's x/y location is center-based, but sprite plotting is upper-left-corner based
-        const double xoffset = 0;// finalWidth / 2;
-        const double yoffset = 0;// finalHeight / 2;
+private:
 
-        double gx, gy, gz;
-        convertToGlutCoords(x, y, gx, gy, gz);
-        glTranslatef(static_cast<GLfloat>(gx-xoffset),static_cast<GLfloat>(gy-yoffset),static_cast<GLfloat>(gz));
-        glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glEnable(GL_TEXTURE_2D);
-        glDisable(GL_DEPTH_TEST);
-        glEnable (GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glBindTexture(GL_TEXTURE_2D, it->second);
+      // Layout matches GL_T2F_V3F
+    struct Vertex
+    {
+        GLfloat u, v;
+        GLfloat x, y, z;
+    };
 
-        glColor3f(1.0, 1.0, 1.0);
+      // Where a frame sits in the atlas, in pixels and as texture coordinates
+    struct FrameRect
+    {
+        bool         loaded;
+        int          page;
+        unsigned int x, y, width, height;
+    };
 
-        double cx1 = 0, cy1 = 0;
-        double cx2 = 1, cy2 = 0;
-        double cx3 = 1, cy3 = 1;
-        double cx4 = 0, cy4 = 1;
-
-          // Rotate sprite.  For 180 degrees, don't rotate, but reflect
-        double rx1, ry1, rx2, ry2, rx3, ry3, rx4, ry4;
-        double rotationAngle = (angleDegrees == 180 ? 0 : angleDegrees);
-        rotate(-finalWidth / 2, -finalHeight / 2, rotationAngle, rx1, ry1);
-        rotate( finalWidth / 2, -finalHeight / 2, rotationAngle, rx2, ry2);
-        rotate( finalWidth / 2,  finalHeight / 2, rotationAngle, rx3, ry3);
-        rotate(-finalWidth / 2,  finalHeight / 2, rotationAngle, rx4, ry4);
-        if (angleDegrees == 180)
-        {
-            // No rotation happened, but reflect to face left
-            std::swap(rx1, rx2);
-            std::swap(rx3, rx4);
-        }
+    struct FrameUV
+    {
+        bool    loaded;
+        int     page;
+        GLfloat u0, v0, u1, v1;
+    };
 
-        glBegin(GL_QUADS);
-        glTexCoord2d(cx1, cy1);
-        glVertex3f(static_cast<GLfloat>(rx1), static_cast<GLfloat>(ry1), 0);
-        glTexCoord2d(cx2, cy2);
-        glVertex3f(static_cast<GLfloat>(rx2), static_cast<GLfloat>(ry2), 0);
-        glTexCoord2d(cx3, cy3);
-        glVertex3f(static_cast<GLfloat>(rx3), static_cast<GLfloat>(ry3), 0);
-        glTexCoord2d(cx4, cy4);
-        glVertex3f(static_cast<GLfloat>(rx4), static_cast<GLfloat>(ry4), 0);
-        glEnd();
+      // One texture of the atlas
+    struct AtlasPage
+    {
+        GLuint                      texture;    // 0 until first uploaded
+        std::vector<unsigned char>  pixels;     // ATLAS_WIDTH pixels per row, bottom row first
+        unsigned int                height;     // rows in use
+        unsigned int                shelfX;
+        unsigned int                shelfY;
+        unsigned int                shelfHeight;
+        bool                        dirty;      // frames added since the last upload
+        unsigned int                textureHeight;  // height rounded up to a power of 2
+        std::vector<std::vector<unsigned char>> mipmaps;   // levels 1 and up, until uploaded
+    };
 
-        glDisable(GL_TEXTURE_2D);
-        glEnable(GL_DEPTH_TEST);
+      // A frame noted by loadSprite() and not yet loaded
+    struct PendingFrame
+    {
+        std::string filename;
+        int         spriteID;
+    };
 
-        glPopAttrib();
-        glPopMatrix();
+      // A frame's TGA file, read and with its header checked.  For a packed
+      // asset, file is a view of the mapped pack.
+    struct DecodedFrame
+    {
+        bool                loaded;
+        AssetData           file;
+        TgaDecoder          decoder;
+        std::uint64_t       hash;       // of the whole file
+    };
 
-        return true;
-    }
+      // A sprite waiting in a render queue
+    struct QueuedSprite
+    {
+        int     imageID;
+        int     frame;
+        double  x;
+        double  y;
+        int     angleDegrees;
+        double  size;
+    };
 
-    ~SpriteManager()
+      // For each corner of a sprite, its offset from the sprite's center as
+      // multiples of the sprite's width and height:
+      //   dx = corner[0] * width + corner[1] * height
+      //   dy = corner[2] * width + corner[3] * height
+    struct Orientation
     {
-        for (auto it = m_imageMap.begin(); it != m_imageMap.end(); it++)
-            glDeleteTextures(1, &it->second);
-    }
+        double corner[4][4];
+    };
 
-private:
+    static const int VERTICES_PER_SPRITE = 4;
+    static const int NUM_ORIENTATIONS = 360;
+
+      // Frames are packed left to right onto shelves ATLAS_WIDTH pixels wide.
+      // Each is surrounded by ATLAS_PADDING pixels copied from its edges and
+      // starts on an ATLAS_PADDING boundary, so the first few mipmap levels
+      // don't blend neighboring frames together.  When a page's shelves
+      // reach ATLAS_MAX_HEIGHT, packing continues on a new page; a texture
+      // that size is safe on any OpenGL we run on.
+    static const unsigned int ATLAS_WIDTH = 1024;
+    static const unsigned int ATLAS_MAX_HEIGHT = 1024;
+    static const unsigned int ATLAS_PADDING = 8;
+    static const int BYTES_PER_PIXEL = 4;   // the atlas is always BGRA, premultiplied
+    static const std::uint32_t CACHE_VERSION = 2;
 
-    std::map<int, GLuint>   m_imageMap;
     std::map<int, int>      m_frameCountPerSprite;
     bool                    m_mipMapped;
+    std::vector<PendingFrame> m_pendingFrames;
+    std::string             m_cacheFile;        // empty for no texture cache
+    std::thread             m_loader;           // owns the atlas while running
+    bool                    m_loadSucceeded;    // false once any file fails to load
+    std::vector<Orientation> m_orientations;   // indexed by angle in degrees
+    RenderQueue             m_queue;            // the current batch
+    std::vector<QueuedSprite> m_queuedSprites;  // indexed by queue payload
+    std::vector<Vertex>     m_vertices;         // the current batch, in queue order
+
+    std::vector<AtlasPage>      m_pages;
+    bool                        m_atlasDirty;       // some page needs uploading
+    std::vector<FrameRect>      m_frameRects;       // indexed by sprite ID
+    std::vector<FrameUV>        m_frameUVs;         // indexed by sprite ID
+
+    RenderQueue                 m_staticQueue;      // the static layer being built
+    std::vector<QueuedSprite>   m_staticSprites;
+    std::vector<Vertex>         m_staticVertices;
+    GLuint                      m_staticList;       // display list; 0 until first built
+    bool                        m_staticLayerValid;
+    int                         m_staticLayerSprites;
+    int                         m_staticLayerBinds;     // compiled into the list
+    int                         m_staticLayerDraws;
+    int                         m_staticLayerLastPage;  // bound when the list finishes
+    double                      m_cameraX;
+    double                      m_cameraY;
 
     static const int INVALID_SPRITE_ID = -1;
     static const int MAX_IMAGES = 1000;
@@ -235,6 +378,649 @@ private:
         yout = y * cos(theta) + x * sin(theta);
     }
 
+      // The atlas coordinates of an uploaded frame, or nullptr
+    const FrameUV* frameUV(int imageID, int frame) const
+    {
+        int spriteID = getSpriteID(imageID, frame);
+        if (spriteID == INVALID_SPRITE_ID  ||  spriteID >= static_cast<int>(m_frameUVs.size())  ||
+            !m_frameUVs[spriteID].loaded)
+            return nullptr;
+        return &m_frameUVs[spriteID];
+    }
+
+    bool queueSprite(RenderQueue& queue, std::vector<QueuedSprite>& sprites, int imageID, int frame,
+                     double x, double y, int angleDegrees, double size, int depth)
+    {
+        const FrameUV* uv = frameUV(imageID, frame);
+        if (uv == nullptr)
+            return false;
+
+        queue.push(depth, uv->page, imageID, static_cast<std::uint32_t>(sprites.size()));
+        sprites.push_back(QueuedSprite{ imageID, frame, x, y, angleDegrees, size });
+        return true;
+    }
+
+      // Sort the queue and lay out its sprites' vertices in that order
+    void buildVertices(RenderQueue& queue, const std::vector<QueuedSprite>& sprites, std::vector<Vertex>& vertices)
+    {
+        queue.sort();
+        vertices.clear();
+        for (size_t k = 0; k < queue.size(); k++)
+        {
+            const QueuedSprite& s = sprites[queue[k].payload];
+            appendSprite(vertices, *frameUV(s.imageID, s.frame), s.x, s.y, s.angleDegrees, s.size);
+        }
+    }
+
+      // Draw a sorted queue's vertices, binding each run's page unless it is
+      // boundPage already
+    void submitRuns(const RenderQueue& queue, const std::vector<Vertex>& vertices, int& boundPage, int& binds, int& draws)
+    {
+        glInterleavedArrays(GL_T2F_V3F, 0, vertices.data());
+        queue.forEachRun([&](int page, size_t first, size_t count)
+        {
+            if (page != boundPage)
+            {
+                glBindTexture(GL_TEXTURE_2D, m_pages[page].texture);
+                boundPage = page;
+                binds++;
+            }
+            glDrawArrays(GL_QUADS, static_cast<GLint>(first * VERTICES_PER_SPRITE),
+                         static_cast<GLsizei>(count * VERTICES_PER_SPRITE));
+            draws++;
+        });
+    }
+
+    void appendSprite(std::vector<Vertex>& vertices, const FrameUV& uv, double x, double y, int angleDegrees, double size)
+    {
+        double finalWidth = SPRITE_WIDTH_GL * size;
+        double finalHeight = SPRITE_HEIGHT_GL * size;
+
+        double gx, gy, gz;
+        convertToGlutCoords(x, y, gx, gy, gz);
+        GLfloat fx = static_cast<GLfloat>(gx);
+        GLfloat fy = static_cast<GLfloat>(gy);
+        GLfloat fz = static_cast<GLfloat>(gz);
+
+        static const GLfloat CORNER_TEX_COORDS[VERTICES_PER_SPRITE][2] = {
+            { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 }
+        };
+
+          // The corner offsets are what rotate() would produce for this
+          // angle (reflected to face left for 180 degrees), looked up
+          // rather than recomputed
+        const Orientation& o = m_orientations[normalizedAngle(angleDegrees)];
+        for (int k = 0; k < VERTICES_PER_SPRITE; k++)
+        {
+            Vertex v;
+            v.u = uv.u0 + CORNER_TEX_COORDS[k][0] * (uv.u1 - uv.u0);
+            v.v = uv.v0 + CORNER_TEX_COORDS[k][1] * (uv.v1 - uv.v0);
+            v.x = fx + static_cast<GLfloat>(o.corner[k][0] * finalWidth + o.corner[k][1] * finalHeight);
+            v.y = fy + static_cast<GLfloat>(o.corner[k][2] * finalWidth + o.corner[k][3] * finalHeight);
+            v.z = fz;
+            vertices.push_back(v);
+        }
+    }
+
+    void beginSpriteState()
+    {
+        glPushMatrix();
+        double gx0, gy0, gx, gy, gz;
+        convertToGlutCoords(0, 0, gx0, gy0, gz);
+        convertToGlutCoords(m_cameraX, m_cameraY, gx, gy, gz);
+        glTranslatef(static_cast<GLfloat>(gx0 - gx), static_cast<GLfloat>(gy0 - gy), 0);
+        glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+        glEnable(GL_TEXTURE_2D);
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);     // the atlas is premultiplied
+        glColor3f(1.0, 1.0, 1.0);
+        Perf().stateChanged();
+    }
+
+    void endSpriteState()
+    {
+        glDisable(GL_TEXTURE_2D);
+        glPopClientAttrib();
+        glPopAttrib();
+        glPopMatrix();
+    }
+
+    static unsigned int roundUpToPadding(unsigned int n)
+    {
+        return (n + ATLAS_PADDING - 1) / ATLAS_PADDING * ATLAS_PADDING;
+    }
+
+      // Run job(k) for each k from 0 to jobs - 1, spread over as many threads
+      // as the machine has cores (this one included)
+    template<typename Func>
+    static void runInParallel(size_t jobs, Func job)
+    {
+        std::atomic<size_t> next(0);
+        auto worker = [&next, jobs, &job]()
+        {
+            for (size_t k = next++; k < jobs; k = next++)
+                job(k);
+        };
+        size_t nThreads = std::min<size_t>(jobs, std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < nThreads; t++)
+            threads.emplace_back(worker);
+        worker();
+        for (std::thread& t : threads)
+            t.join();
+    }
+
+      // Runs on m_loader: read the files in parallel, lay their frames out
+      // in the atlas in the order they were noted (so the layout doesn't
+      // depend on which finished first), decode each frame straight into
+      // its place in parallel, then build the changed pages' mipmaps in
+      // parallel
+    void loadFrames(std::vector<PendingFrame> frames)
+    {
+        std::vector<DecodedFrame> decoded(frames.size());
+        runInParallel(frames.size(), [&frames, &decoded](size_t k)
+        {
+            decoded[k].loaded = readTGA(frames[k].filename, decoded[k]);
+            decoded[k].hash = (decoded[k].loaded ? hashBytes(decoded[k].file.data(), decoded[k].file.size()) : 0);
+        });
+
+          // Only a complete atlas built from scratch is cached
+        bool cacheable = !m_cacheFile.empty()  &&  m_pages.empty()  &&  m_frameRects.empty();
+        for (const DecodedFrame& d : decoded)
+            cacheable = cacheable  &&  d.loaded;
+        std::uint64_t cacheKey = 0;
+        if (cacheable)
+        {
+            cacheKey = hashBytes(nullptr, 0, CACHE_VERSION * 2 + (m_mipMapped ? 1 : 0));
+            for (size_t k = 0; k < frames.size(); k++)
+            {
+                std::uint64_t ids[2] = { static_cast<std::uint64_t>(frames[k].spriteID), decoded[k].hash };
+                cacheKey = hashBytes(reinterpret_cast<const char*>(ids), sizeof(ids), cacheKey);
+            }
+            if (readCache(cacheKey))
+                return;
+        }
+
+        for (size_t k = 0; k < frames.size(); k++)
+        {
+            DecodedFrame& d = decoded[k];
+            if (d.loaded)
+                d.loaded = placeInAtlas(frames[k].spriteID, d.decoder.width(), d.decoder.height());
+        }
+        for (AtlasPage& page : m_pages)
+        {
+            size_t neededBytes = static_cast<size_t>(ATLAS_WIDTH) * page.height * BYTES_PER_PIXEL;
+            if (page.pixels.size() < neededBytes)
+                page.pixels.resize(neededBytes, 0);
+        }
+          // Frames never share pixels, so they can be filled in at once
+        runInParallel(frames.size(), [this, &frames, &decoded](size_t k)
+        {
+            if (decoded[k].loaded)
+                decoded[k].loaded = fillFrame(m_frameRects[frames[k].spriteID], decoded[k].decoder);
+        });
+        for (size_t k = 0; k < frames.size(); k++)
+        {
+            if (!decoded[k].loaded)
+            {
+                if (frames[k].spriteID < static_cast<int>(m_frameRects.size()))
+                    m_frameRects[frames[k].spriteID].loaded = false;
+                std::cerr << "Cannot load " << frames[k].filename << std::endl;
+                m_loadSucceeded = false;
+            }
+        }
+
+        std::vector<AtlasPage*> changed;
+        for (AtlasPage& page : m_pages)
+        {
+            if (page.dirty)
+                changed.push_back(&page);
+        }
+        runInParallel(changed.size(), [this, &changed](size_t k)
+        {
+            finishPage(*changed[k]);
+        });
+
+        if (cacheable  &&  m_loadSucceeded  &&  !writeCache(cacheKey))
+            std::cerr << "Cannot write texture cache " << m_cacheFile << std::endl;
+    }
+
+      // A 64-bit hash of size bytes, mixing in 8 bytes at a time.  It only
+      // has to tell versions of the same files apart, not resist attack.
+    static std::uint64_t hashBytes(const char* data, size_t size, std::uint64_t seed = 0)
+    {
+        const std::uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ull;
+        std::uint64_t h = seed ^ (size * MULTIPLIER);
+        size_t k = 0;
+        for ( ; k + 8 <= size; k += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data + k, 8);
+            h = (h ^ word) * MULTIPLIER;
+            h ^= h >> 29;
+        }
+        for ( ; k < size; k++)
+        {
+            h = (h ^ static_cast<unsigned char>(data[k])) * MULTIPLIER;
+            h ^= h >> 29;
+        }
+        return h ^ (h >> 32);
+    }
+
+      // The texture cache file holds, after a header giving the key, the
+      // frames' places in the atlas, then each page's shelf state and its
+      // pixels, level 0 first and each mipmap level after, just as
+      // uploadAtlas() hands them to glTexImage2D.  Numbers are 32 bits,
+      // little-endian, except the 64-bit key.
+
+    static void putNumber(std::vector<char>& out, std::uint64_t n, int bytes)
+    {
+        for (int k = 0; k < bytes; k++)
+            out.push_back(static_cast<char>((n >> (8 * k)) & 0xff));
+    }
+
+    static bool getNumber(std::istream& in, std::uint64_t& n, int bytes)
+    {
+        unsigned char b[8];
+        if (!in.read(reinterpret_cast<char*>(b), bytes))
+            return false;
+        n = 0;
+        for (int k = bytes - 1; k >= 0; k--)
+            n = (n << 8) | b[k];
+        return true;
+    }
+
+    static const char* cacheMagic()
+    {
+        return "ZDTC";
+    }
+
+    static size_t levelBytes(unsigned int textureHeight, size_t level)
+    {
+        return static_cast<size_t>(std::max(1u, ATLAS_WIDTH >> level)) *
+               std::max(1u, textureHeight >> level) * BYTES_PER_PIXEL;
+    }
+
+    bool writeCache(std::uint64_t key) const
+    {
+        std::vector<char> header(cacheMagic(), cacheMagic() + 4);
+        putNumber(header, CACHE_VERSION, 4);
+        putNumber(header, key, 8);
+        putNumber(header, m_pages.size(), 4);
+        putNumber(header, m_frameRects.size(), 4);
+        for (const FrameRect& r : m_frameRects)
+        {
+            putNumber(header, r.loaded ? 1 : 0, 4);
+            putNumber(header, r.page, 4);
+            putNumber(header, r.x, 4);
+            putNumber(header, r.y, 4);
+            putNumber(header, r.width, 4);
+            putNumber(header, r.height, 4);
+        }
+
+        std::ofstream cache(m_cacheFile, std::ios::out|std::ios::binary);
+        cache.write(header.data(), header.size());
+        for (const AtlasPage& page : m_pages)
+        {
+            std::vector<char> pageHeader;
+            putNumber(pageHeader, page.height, 4);
+            putNumber(pageHeader, page.shelfX, 4);
+            putNumber(pageHeader, page.shelfY, 4);
+            putNumber(pageHeader, page.shelfHeight, 4);
+            putNumber(pageHeader, page.textureHeight, 4);
+            putNumber(pageHeader, page.mipmaps.size(), 4);
+            cache.write(pageHeader.data(), pageHeader.size());
+            cache.write(reinterpret_cast<const char*>(page.pixels.data()), page.pixels.size());
+            for (const std::vector<unsigned char>& level : page.mipmaps)
+                cache.write(reinterpret_cast<const char*>(level.data()), level.size());
+        }
+        return static_cast<bool>(cache);
+    }
+
+      // Fill the atlas from the cache if it holds the one for key; anything
+      // that doesn't check out is treated as a miss
+    bool readCache(std::uint64_t key)
+    {
+        std::ifstream cache(m_cacheFile, std::ios::in|std::ios::binary);
+        char magic[4];
+        std::uint64_t version, cachedKey, nPages, nRects;
+        if (!cache.read(magic, 4)  ||  std::memcmp(magic, cacheMagic(), 4) != 0  ||
+            !getNumber(cache, version, 4)  ||  version != CACHE_VERSION  ||
+            !getNumber(cache, cachedKey, 8)  ||  cachedKey != key  ||
+            !getNumber(cache, nPages, 4)  ||  !getNumber(cache, nRects, 4)  ||
+            nRects > static_cast<std::uint64_t>(MAX_IMAGES) * MAX_FRAMES_PER_SPRITE  ||
+            nPages == 0  ||  nPages > nRects)     // every page holds a frame
+            return false;
+
+        std::vector<FrameRect> rects(static_cast<size_t>(nRects));
+        for (FrameRect& r : rects)
+        {
+            std::uint64_t v[6];
+            for (std::uint64_t& n : v)
+            {
+                if (!getNumber(cache, n, 4))
+                    return false;
+            }
+            if (v[1] >= nPages  ||  v[2] + v[4] > ATLAS_WIDTH)
+                return false;
+            r = FrameRect{ v[0] != 0, static_cast<int>(v[1]), static_cast<unsigned int>(v[2]), static_cast<unsigned int>(v[3]),
+                           static_cast<unsigned int>(v[4]), static_cast<unsigned int>(v[5]) };
+        }
+
+        std::vector<AtlasPage> pages(static_cast<size_t>(nPages));
+        for (AtlasPage& page : pages)
+        {
+            std::uint64_t v[6];
+            for (std::uint64_t& n : v)
+            {
+                if (!getNumber(cache, n, 4))
+                    return false;
+            }
+            unsigned int textureHeight = static_cast<unsigned int>(v[4]);
+            size_t nLevels = 0;
+            if (m_mipMapped)
+            {
+                for (unsigned int w = ATLAS_WIDTH, h = textureHeight; w > 1  ||  h > 1; w = std::max(1u, w / 2), h = std::max(1u, h / 2))
+                    nLevels++;
+            }
+            if (textureHeight == 0  ||  textureHeight > ATLAS_MAX_HEIGHT  ||  (textureHeight & (textureHeight - 1)) != 0  ||
+                v[0] > textureHeight  ||  v[5] != nLevels)
+                return false;
+
+            page = AtlasPage{ 0, std::vector<unsigned char>(levelBytes(textureHeight, 0)),
+                              static_cast<unsigned int>(v[0]), static_cast<unsigned int>(v[1]),
+                              static_cast<unsigned int>(v[2]), static_cast<unsigned int>(v[3]),
+                              true, textureHeight, std::vector<std::vector<unsigned char>>(nLevels) };
+            if (!cache.read(reinterpret_cast<char*>(page.pixels.data()), page.pixels.size()))
+                return false;
+            for (size_t level = 0; level < nLevels; level++)
+            {
+                page.mipmaps[level].resize(levelBytes(textureHeight, level + 1));
+                if (!cache.read(reinterpret_cast<char*>(page.mipmaps[level].data()), page.mipmaps[level].size()))
+                    return false;
+            }
+        }
+
+          // Frames must lie within their pages
+        for (const FrameRect& r : rects)
+        {
+            if (static_cast<std::uint64_t>(r.y) + r.height > pages[r.page].textureHeight)
+                return false;
+        }
+
+        m_pages.swap(pages);
+        m_frameRects.swap(rects);
+        m_atlasDirty = !m_pages.empty();
+        return true;
+    }
+
+    static bool readTGA(const std::string& filename_tga, DecodedFrame& frame)
+    {
+        return Assets().read(filename_tga, frame.file)  &&
+               frame.decoder.parse(frame.file.data(), frame.file.size());
+    }
+
+      // Pad a changed page to a power-of-2 height and build its mipmaps,
+      // so that uploading it is nothing but glTexImage2D calls
+    void finishPage(AtlasPage& page) const
+    {
+        page.textureHeight = 1;
+        while (page.textureHeight < page.height)
+            page.textureHeight *= 2;
+        page.pixels.resize(static_cast<size_t>(ATLAS_WIDTH) * page.textureHeight * BYTES_PER_PIXEL, 0);
+
+        page.mipmaps.clear();
+        if (!m_mipMapped)
+            return;
+        const unsigned char* source = page.pixels.data();
+        unsigned int width = ATLAS_WIDTH;
+        unsigned int height = page.textureHeight;
+        while (width > 1  ||  height > 1)
+        {
+            page.mipmaps.push_back(halveImage(source, width, height));
+            source = page.mipmaps.back().data();
+            width = std::max(1u, width / 2);
+            height = std::max(1u, height / 2);
+        }
+    }
+
+      // The next smaller mipmap level of a BGRA image whose sides are powers
+      // of 2, averaging each 2x2 block (or pair, once a side is down to 1)
+      // the way gluBuild2DMipmaps does
+    static std::vector<unsigned char> halveImage(const unsigned char* source, unsigned int width, unsigned int height)
+    {
+        unsigned int newWidth = std::max(1u, width / 2);
+        unsigned int newHeight = std::max(1u, height / 2);
+        std::vector<unsigned char> result(static_cast<size_t>(newWidth) * newHeight * BYTES_PER_PIXEL);
+        size_t rowBytes = static_cast<size_t>(width) * BYTES_PER_PIXEL;
+        unsigned char* dest = result.data();
+        for (unsigned int y = 0; y < newHeight; y++)
+        {
+            for (unsigned int x = 0; x < newWidth; x++)
+            {
+                for (int c = 0; c < BYTES_PER_PIXEL; c++)
+                {
+                    if (width > 1  &&  height > 1)
+                    {
+                        const unsigned char* s = source + 2 * y * rowBytes + (2 * x) * BYTES_PER_PIXEL + c;
+                        *dest++ = static_cast<unsigned char>((s[0] + s[BYTES_PER_PIXEL] + s[rowBytes] + s[rowBytes + BYTES_PER_PIXEL] + 2) / 4);
+                    }
+                    else if (width > 1)
+                    {
+                        const unsigned char* s = source + (2 * x) * BYTES_PER_PIXEL + c;
+                        *dest++ = static_cast<unsigned char>((s[0] + s[BYTES_PER_PIXEL]) / 2);
+                    }
+                    else
+                    {
+                        const unsigned char* s = source + 2 * y * rowBytes + c;
+                        *dest++ = static_cast<unsigned char>((s[0] + s[rowBytes]) / 2);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+      // Reserve the next free spot in the atlas for a frame.  The page grows
+      // to cover it, but its pixels are left for fillFrame().
+    bool placeInAtlas(int spriteID, unsigned int width, unsigned int height)
+    {
+        if (width == 0  ||  height == 0)
+            return false;
+
+        unsigned int cellWidth = roundUpToPadding(width + 2 * ATLAS_PADDING);
+        unsigned int cellHeight = roundUpToPadding(height + 2 * ATLAS_PADDING);
+        if (cellWidth > ATLAS_WIDTH  ||  cellHeight > ATLAS_MAX_HEIGHT)
+        {
+            std::cerr << "Sprite frame is too large for the texture atlas" << std::endl;
+            return false;
+        }
+
+        if (m_pages.empty())
+            m_pages.push_back(AtlasPage{ 0, std::vector<unsigned char>(), 0, 0, 0, 0, false, 0, {} });
+        AtlasPage* page = &m_pages.back();
+        if (page->shelfX + cellWidth > ATLAS_WIDTH)   // start a new shelf
+        {
+            page->shelfY += page->shelfHeight;
+            page->shelfX = 0;
+            page->shelfHeight = 0;
+        }
+        if (page->shelfY + cellHeight > ATLAS_MAX_HEIGHT)   // start a new page
+        {
+            m_pages.push_back(AtlasPage{ 0, std::vector<unsigned char>(), 0, 0, 0, 0, false, 0, {} });
+            page = &m_pages.back();
+        }
+        unsigned int left = page->shelfX + ATLAS_PADDING;
+        unsigned int bottom = page->shelfY + ATLAS_PADDING;
+        page->shelfX += cellWidth;
+        page->shelfHeight = std::max(page->shelfHeight, cellHeight);
+        page->height = std::max(page->height, page->shelfY + page->shelfHeight);
+
+        if (spriteID >= static_cast<int>(m_frameRects.size()))
+            m_frameRects.resize(spriteID + 1, FrameRect{ false, 0, 0, 0, 0, 0 });
+        m_frameRects[spriteID] = FrameRect{ true, static_cast<int>(m_pages.size()) - 1, left, bottom, width, height };
+        page->dirty = true;
+        m_atlasDirty = true;
+        return true;
+    }
+
+      // Decode a frame into the spot placeInAtlas() reserved, whose page's
+      // pixels must already cover it, then surround it with copies of its
+      // edge pixels
+    bool fillFrame(const FrameRect& r, TgaDecoder& decoder)
+    {
+        AtlasPage& page = m_pages[r.page];
+        const size_t rowBytes = static_cast<size_t>(ATLAS_WIDTH) * BYTES_PER_PIXEL;
+        unsigned char* origin = &page.pixels[(static_cast<size_t>(r.y) * ATLAS_WIDTH + r.x) * BYTES_PER_PIXEL];
+        if (!decoder.decode(origin, rowBytes))
+            return false;
+
+        const int pad = ATLAS_PADDING;
+        for (unsigned int y = 0; y < r.height; y++)
+        {
+            unsigned char* row = origin + y * rowBytes;
+            unsigned char* last = row + (r.width - 1) * BYTES_PER_PIXEL;
+            for (int k = 1; k <= pad; k++)
+            {
+                std::memcpy(row - k * BYTES_PER_PIXEL, row, BYTES_PER_PIXEL);
+                std::memcpy(last + k * BYTES_PER_PIXEL, last, BYTES_PER_PIXEL);
+            }
+        }
+        size_t paddedBytes = (r.width + 2 * pad) * BYTES_PER_PIXEL;
+        unsigned char* bottomRow = origin - pad * BYTES_PER_PIXEL;
+        unsigned char* topRow = bottomRow + (r.height - 1) * rowBytes;
+        for (int k = 1; k <= pad; k++)
+        {
+            std::memcpy(bottomRow - k * rowBytes, bottomRow, paddedBytes);
+            std::memcpy(topRow + k * rowBytes, topRow, paddedBytes);
+        }
+        return true;
+    }
+
+      // Give OpenGL the atlas pages that changed and work out every frame's
+      // texture coordinates in its page
+    void uploadAtlas()
+    {
+        m_atlasDirty = false;
+        m_staticLayerValid = false;     // its texture coordinates may have moved
+
+        GLint maxTextureSize;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        for (AtlasPage& page : m_pages)
+        {
+            if (!page.dirty)
+                continue;
+            page.dirty = false;
+
+            if (ATLAS_WIDTH > static_cast<unsigned int>(maxTextureSize)  ||
+                page.textureHeight > static_cast<unsigned int>(maxTextureSize))
+            {
+                std::cerr << "Texture atlas (" << ATLAS_WIDTH << "x" << page.textureHeight
+                          << ") is larger than OpenGL allows" << std::endl;
+                return;
+            }
+
+              // Transfer Texture To OpenGL
+
+            if (page.texture == 0)
+                glGenTextures(1, &page.texture);
+
+            glBindTexture(GL_TEXTURE_2D, page.texture);
+
+            glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+            if (m_mipMapped)
+            {
+                  // when texture area is small, bilinear filter the closest mipmap
+                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                  // when texture area is large, bilinear filter the first mipmap
+                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            }
+            else
+            {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            }
+
+              // Have the texture wrap both vertically and horizontally.
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLfloat>(GL_REPEAT));
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLfloat>(GL_REPEAT));
+
+              // The mipmaps were built along with the page (see finishPage())
+            glTexImage2D(GL_TEXTURE_2D, 0, 4, ATLAS_WIDTH, page.textureHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE,
+                         page.pixels.data());
+            unsigned int width = ATLAS_WIDTH;
+            unsigned int height = page.textureHeight;
+            for (size_t level = 0; level < page.mipmaps.size(); level++)
+            {
+                width = std::max(1u, width / 2);
+                height = std::max(1u, height / 2);
+                glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level + 1), 4, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE,
+                             page.mipmaps[level].data());
+            }
+            std::vector<std::vector<unsigned char>>().swap(page.mipmaps);
+        }
+
+        m_frameUVs.assign(m_frameRects.size(), FrameUV{ false, 0, 0, 0, 0, 0 });
+        for (size_t k = 0; k < m_frameRects.size(); k++)
+        {
+            const FrameRect& r = m_frameRects[k];
+            if (!r.loaded)
+                continue;
+            unsigned int textureHeight = m_pages[r.page].textureHeight;
+            m_frameUVs[k].loaded = true;
+            m_frameUVs[k].page = r.page;
+            m_frameUVs[k].u0 = static_cast<GLfloat>(r.x) / ATLAS_WIDTH;
+            m_frameUVs[k].v0 = static_cast<GLfloat>(r.y) / textureHeight;
+            m_frameUVs[k].u1 = static_cast<GLfloat>(r.x + r.width) / ATLAS_WIDTH;
+            m_frameUVs[k].v1 = static_cast<GLfloat>(r.y + r.height) / textureHeight;
+        }
+    }
+
+    static int normalizedAngle(int angleDegrees)
+    {
+        int a = angleDegrees % NUM_ORIENTATIONS;
+        return (a < 0 ? a + NUM_ORIENTATIONS : a);
+    }
+
+    void buildOrientations()
+    {
+        static const double CORNER_SIGNS[VERTICES_PER_SPRITE][2] = {
+            { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 }
+        };
+
+        m_orientations.resize(NUM_ORIENTATIONS);
+        for (int angle = 0; angle < NUM_ORIENTATIONS; angle++)
+        {
+              // Rotate sprite.  For 180 degrees, don't rotate, but reflect
+            double rotationAngle = (angle == 180 ? 0 : angle);
+            Orientation& o = m_orientations[angle];
+            for (int k = 0; k < VERTICES_PER_SPRITE; k++)
+            {
+                  // rotate() is linear, so rotating the half-width and
+                  // half-height separately gives the coefficients
+                double xw, yw, xh, yh;
+                rotate(CORNER_SIGNS[k][0] / 2, 0, rotationAngle, xw, yw);
+                rotate(0, CORNER_SIGNS[k][1] / 2, rotationAngle, xh, yh);
+                o.corner[k][0] = xw;
+                o.corner[k][1] = xh;
+                o.corner[k][2] = yw;
+                o.corner[k][3] = yh;
+            }
+            if (angle == 180)
+            {
+                  // No rotation happened, but reflect to face left
+                for (int c = 0; c < 2; c++)
+                {
+                    std::swap(o.corner[0][c], o.corner[1][c]);
+                    std::swap(o.corner[2][c], o.corner[3][c]);
+                }
+            }
+        }
+    }
+
     static void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz)
     {
         x /= VIEW_WIDTH;
@@ -243,18 +1029,6 @@ private:
         gy = 2 * VISIBLE_MIN_Y +      y * 2 * (VISIBLE_MAX_Y - VISIBLE_MIN_Y);
         gz = .6 * VISIBLE_MIN_Z;
     }
-
-    static void makeMipmaps(unsigned char byteCount, unsigned int textureWidth, unsigned int textureHeight, char* imageData)
-    {
-        int format = (byteCount == 3 ? GL_BGR : GL_BGRA);
-#ifdef __APPLE__
-        int internalFormat = (byteCount == 3 ? GL_RGB : GL_RGBA);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, imageData);
-        glGenerateMipmap(GL_TEXTURE_2D);
-#else
-        gluBuild2DMipmaps(GL_TEXTURE_2D, byteCount, textureWidth, textureHeight, format, GL_UNSIGNED_BYTE, imageData);
-#endif
-    }
 };
 
 #endif // SPRITEMANAGER_H_
@@ -0,0 +1,56 @@
+#ifndef SPSCRING_H_
+#define SPSCRING_H_
+
+#include <atomic>
+#include <cstddef>
+
+  // Wait-free single-producer, single-consumer queue of at most N items
+  // in a fixed ring (N must be a power of 2).  One thread calls
+  // push(), another calls pop(); each is a couple of loads and a store,
+  // never a lock or a retry loop.  push() fails rather than waits when the
+  // ring is full.
+
+template<typename T, size_t N>
+class SpscRing
+{
+    static_assert(N >= 2  &&  (N & (N - 1)) == 0, "SpscRing size must be a power of 2");
+
+  public:
+    SpscRing()
+     : m_head(0), m_tail(0)
+    {}
+
+      // Producer side
+
+    bool push(const T& item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= N)
+            return false;
+        m_items[tail & (N - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+      // Consumer side
+
+    bool pop(T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+        item = m_items[head & (N - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+  private:
+    T                   m_items[N];
+    std::atomic<size_t> m_head;     // next item to pop; written only by the consumer
+    std::atomic<size_t> m_tail;     // next slot to fill; written only by the producer
+};
+
+#endif // SPSCRING_H_
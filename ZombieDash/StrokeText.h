@@ -0,0 +1,102 @@
+#ifndef STROKETEXT_H_
+#define STROKETEXT_H_
+
+#include "freeglut.h"
+#include <string>
+
+  // Text in the GLUT stroke font, drawn from display lists rather than by
+  // calling glutStrokeCharacter for every character of every frame.  Each
+  // character's strokes (and the advance past it) are compiled into a list
+  // of their own the first time any text is drawn.  Strings that are drawn
+  // every frame but rarely change go in a StrokeLabel, which compiles the
+  // whole string into one list and measures it only when it changes.
+
+class StrokeFont
+{
+  public:
+      // Compile the glyphs now if they aren't already; this can't happen
+      // while another display list is being compiled
+    static void load()
+    {
+        glyphLists();
+    }
+
+      // Draw str at the current transform, in stroke font units
+    static void draw(const char* str)
+    {
+        GLuint base = glyphLists();
+        for ( ; *str != '\0'; str++)
+            glCallList(base + static_cast<unsigned char>(*str));
+    }
+
+  private:
+    static const int NUM_GLYPHS = 256;
+
+    static GLuint glyphLists()
+    {
+        static GLuint base = 0;
+        if (base == 0)
+        {
+            base = glGenLists(NUM_GLYPHS);
+            for (int c = 0; c < NUM_GLYPHS; c++)
+            {
+                glNewList(base + c, GL_COMPILE);
+                glutStrokeCharacter(GLUT_STROKE_ROMAN, c);
+                glEndList();
+            }
+        }
+        return base;
+    }
+};
+
+class StrokeLabel
+{
+  public:
+    StrokeLabel()
+     : m_list(0), m_width(0)
+    {}
+
+    ~StrokeLabel()
+    {
+        if (m_list != 0)
+            glDeleteLists(m_list, 1);
+    }
+
+      // Recompile the label if text differs from what it shows now
+    void setText(const std::string& text)
+    {
+        if (m_list != 0  &&  text == m_text)
+            return;
+
+        m_text = text;
+        m_width = glutStrokeLength(GLUT_STROKE_ROMAN, reinterpret_cast<const unsigned char*>(m_text.c_str()));
+        StrokeFont::load();
+        if (m_list == 0)
+            m_list = glGenLists(1);
+        glNewList(m_list, GL_COMPILE);
+        StrokeFont::draw(m_text.c_str());
+        glEndList();
+    }
+
+      // Width of the text in stroke font units
+    double width() const
+    {
+        return m_width;
+    }
+
+    void draw() const
+    {
+        if (m_list != 0)
+            glCallList(m_list);
+    }
+
+    StrokeLabel(const StrokeLabel&) = delete;
+    StrokeLabel& operator=(const StrokeLabel&) = delete;
+
+  private:
+    GLuint      m_list;     // 0 until the first setText()
+    std::string m_text;
+    double      m_width;
+};
+
+#endif // STROKETEXT_H_
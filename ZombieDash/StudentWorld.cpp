@@ -2,6 +2,7 @@
 #include "GameConstants.h"
 #include "Actor.h"
 #include "Level.h"
+#include "Profiler.h"
 #include <cmath>
 using namespace std;
 
@@ -10,7 +11,9 @@ GameWorld* createStudentWorld(string assetPath) {
 }
 
 StudentWorld::StudentWorld(string assetPath)
-	: GameWorld(assetPath) {}
+	: GameWorld(assetPath), m_penelope(nullptr) {
+	initializeAllValues();
+}
 
 StudentWorld::~StudentWorld() {
 	cleanUp();
@@ -37,9 +40,11 @@ int StudentWorld::init() {
 		cerr << "Successfully loaded level" << endl;
 
 		initializeAllValues();	// initialize all studentworld data members
+		m_levelWidth = lev.getWidth();
+		m_levelHeight = lev.getHeight();
 
-		for (int y = 0; y < LEVEL_HEIGHT; y++) {		// string rows
-			for (int x = 0; x < LEVEL_WIDTH; x++) {		// string cols
+		for (int y = 0; y < lev.getHeight(); y++) {		// string rows
+			for (int x = 0; x < lev.getWidth(); x++) {		// string cols
 				Level::MazeEntry ge = lev.getContentsOf(x, y);	// level_x = 5, level_y = 10
 				switch (ge) {									// so x = 80 and y = 160
 				case Level::wall:				// creates wall
@@ -101,12 +106,16 @@ int StudentWorld::init() {
 }
 
 int StudentWorld::move() {
+	PROFILE_SCOPE("StudentWorld::move");
 	std::vector<Actor*>::iterator i;
 	if (!m_penelope->isDead()) {
+		PROFILE_SCOPE("actors doSomething");
 		// give all actors a chance to do something
 		m_penelope->doSomething();
-		for (i = m_actors.begin(); i != m_actors.end(); i++) {
-			(*i)->doSomething();
+		// index rather than iterate: actors may add new actors (flames,
+		// vomit, zombies) while doing something, which can reallocate m_actors
+		for (size_t k = 0; k < m_actors.size(); k++) {
+			m_actors[k]->doSomething();
 		}
 
 		if (m_penelope->isDead()) {		// if Penelope died during this tick
@@ -121,19 +130,25 @@ int StudentWorld::move() {
 	}
 
 	// Remove newly-dead actors after each tick
-	i = m_actors.begin();
-	while (i != m_actors.end()) {
-		if ((*i)->isDead()) {
-			delete *i;
-			i = m_actors.erase(i);
-		}
-		else {
-			i++;
+	{
+		PROFILE_SCOPE("remove dead actors");
+		i = m_actors.begin();
+		while (i != m_actors.end()) {
+			if ((*i)->isDead()) {
+				delete *i;
+				i = m_actors.erase(i);
+			}
+			else {
+				i++;
+			}
 		}
 	}
 
-	// update the score/lives/level text at screen top
-	setDisplayText();
+	// update the score/lives/level text at screen top, unless this tick
+	// is being fast-forwarded past
+	if (isTickShown()) {
+		setDisplayText();
+	}
 
 	// the player hasn’t completed the current level and hasn’t died, so
 	// continue playing the current level
@@ -165,11 +180,30 @@ void StudentWorld::decNCitizens() {
 	m_nCitizens--;
 }
 
+int StudentWorld::nActors() const {
+	return m_actors.size();
+}
+
+void StudentWorld::getCameraFocus(double& x, double& y) const {
+	if (m_penelope == nullptr) {	// no level loaded
+		GameWorld::getCameraFocus(x, y);
+		return;
+	}
+	x = m_penelope->getX() + SPRITE_WIDTH / 2;
+	y = m_penelope->getY() + SPRITE_HEIGHT / 2;
+}
+
+void StudentWorld::getWorldSize(double& width, double& height) const {
+	width = m_levelWidth * SPRITE_WIDTH;
+	height = m_levelHeight * SPRITE_HEIGHT;
+}
+
 bool StudentWorld::levelFinishedIfAllCitizensGone() const {
 	return m_levelFinishedIfAllCitizensGone;
 }
 
 void StudentWorld::addActor(Actor * a) {
+	a->setID(m_nextActorID++);		// so m_actors stays in ID order
 	m_actors.push_back(a);
 }
 
@@ -182,6 +216,8 @@ void StudentWorld::recordLevelFinishedIfAllCitizensGone() {
 }
 
 void StudentWorld::activateOnAppropriateActors(Actor* a) {
+	PROFILE_QUERY(query_activate_on_appropriate_actors);
+
 	// An object overlaps if Euclidean distance <= 10
 	// i.e.: x^2 + y^2 <= 10^2
 
@@ -192,20 +228,24 @@ void StudentWorld::activateOnAppropriateActors(Actor* a) {
 		a->activateIfAppropriate(m_penelope);
 	}
 
-	// check other actors
-	for (std::vector<Actor*>::iterator i = m_actors.begin(); i != m_actors.end(); i++) {
-		if (*i != a) {	// make sure we don't act on same actor
-			deltaX = (*i)->getX() - a->getX();
-			deltaY = (*i)->getY() - a->getY();
+	// check other actors (by index, since activating a landmine adds flames)
+	for (size_t k = 0; k < m_actors.size(); k++) {
+		Actor* other = m_actors[k];
+		PROFILE_QUERY_SCANNED();
+		if (other != a) {	// make sure we don't act on same actor
+			deltaX = other->getX() - a->getX();
+			deltaY = other->getY() - a->getY();
 			if ((deltaX*deltaX) + (deltaY*deltaY) <= 100) {		// if overlaps, activate
-				a->activateIfAppropriate(*i);
+				a->activateIfAppropriate(other);
 			}
 		}
 	}
 }
 
 bool StudentWorld::isAgentMovementBlockedAt(double x, double y) {
+	PROFILE_QUERY(query_agent_movement_blocked);
 	for (std::vector<Actor*>::iterator i = m_actors.begin(); i != m_actors.end(); i++) {
+		PROFILE_QUERY_SCANNED();
 		if ((*i)->blocksMovement() &&	// if actor blocks movement, check coordinates
 			x >= (*i)->getX() && x <= (*i)->getX() + SPRITE_WIDTH - 1 &&	// if x is within width of actor
 			y >= (*i)->getY() && y <= (*i)->getY() + SPRITE_HEIGHT - 1) {	// if y is within height of actor
@@ -218,7 +258,9 @@ bool StudentWorld::isAgentMovementBlockedAt(double x, double y) {
 }
 
 bool StudentWorld::isFlameBlockedAt(double x, double y) {
+	PROFILE_QUERY(query_flame_blocked);
 	for (std::vector<Actor*>::iterator i = m_actors.begin(); i != m_actors.end(); i++) {
+		PROFILE_QUERY_SCANNED();
 		if ((*i)->blocksFlame() &&	// if actor blocks flame, check coordinates
 			x >= (*i)->getX() && x <= (*i)->getX() + SPRITE_WIDTH - 1 &&	// if x is within width of actor
 			y >= (*i)->getY() && y <= (*i)->getY() + SPRITE_HEIGHT - 1) {	// if y is within height of actor
@@ -231,6 +273,8 @@ bool StudentWorld::isFlameBlockedAt(double x, double y) {
 }
 
 bool StudentWorld::isZombieVomitTriggerAt(double x, double y) {
+	PROFILE_QUERY(query_zombie_vomit_trigger);
+
 	// vomit is triggered with humans (Penelope, citizens)
 
 	// check Penelope first
@@ -240,6 +284,7 @@ bool StudentWorld::isZombieVomitTriggerAt(double x, double y) {
 
 	// check citizens
 	for (std::vector<Actor*>::iterator i = m_actors.begin(); i != m_actors.end(); i++) {
+		PROFILE_QUERY_SCANNED();
 		if ((*i)->triggersZombieVomit() &&
 			(*i)->getX() == x && (*i)->getY() == y) {
 			return true;
@@ -250,6 +295,7 @@ bool StudentWorld::isZombieVomitTriggerAt(double x, double y) {
 }
 
 void StudentWorld::setDisplayText() {
+	PROFILE_SCOPE("StudentWorld::setDisplayText");
 	int score = getScore();
 	int level = getLevel();
 	int lives = getLives();
@@ -259,39 +305,42 @@ void StudentWorld::setDisplayText() {
 	int infected = m_penelope->getInfectionDuration();
 
 	// create display string
-	string toDisplay = formatDisplayText(score, level, lives, vaccines, flames, mines, infected);
+	DisplayText toDisplay;
+	formatDisplayText(toDisplay, score, level, lives, vaccines, flames, mines, infected);
 
-	// display formatted string
-	setGameStatText(toDisplay);
+	// display formatted string, if it changed
+	if (toDisplay != m_displayText) {
+		m_displayText = toDisplay;
+		setGameStatText(m_displayText.c_str());
+	}
 }
 
-std::string StudentWorld::formatDisplayText(int score, int level, int lives, int vaccines, int flames, int mines, int infected) const {
-	string s = "Score: ";
-	s += formatDigit(score, 6, true);
+void StudentWorld::formatDisplayText(DisplayText& s, int score, int level, int lives, int vaccines, int flames, int mines, int infected) const {
+	s.clear();
+	s.append("Score: ");
+	formatDigit(s, score, 6, true);
 
-	s += "  Level: ";
-	s += formatDigit(level, 2, false);
+	s.append("  Level: ");
+	formatDigit(s, level, 2, false);
 
-	s += "  Lives: ";
-	s += formatDigit(lives, 1, true);
+	s.append("  Lives: ");
+	formatDigit(s, lives, 1, true);
 
-	s += "  Vaccines: ";
-	s += formatDigit(vaccines, 2, false);
+	s.append("  Vaccines: ");
+	formatDigit(s, vaccines, 2, false);
 
-	s += "  Flames: ";
-	s += formatDigit(flames, 2, false);
+	s.append("  Flames: ");
+	formatDigit(s, flames, 2, false);
 
-	s += "  Mines: ";
-	s += formatDigit(mines, 2, false);
+	s.append("  Mines: ");
+	formatDigit(s, mines, 2, false);
 
-	s += "  Infected: ";
-	s += formatDigit(infected, 1, false);
-
-	return s;
+	s.append("  Infected: ");
+	formatDigit(s, infected, 1, false);
 }
 
-// Format the score to append to the display text
-std::string StudentWorld::formatDigit(int input, int totalDigits, bool zeros) const {
+// Format the score and append it to the display text
+void StudentWorld::formatDigit(DisplayText& s, int input, int totalDigits, bool zeros) const {
 	char leading;			// leading char
 	if (zeros) {			// if there are zeros
 		leading = '0';
@@ -300,26 +349,116 @@ std::string StudentWorld::formatDigit(int input, int totalDigits, bool zeros) co
 		leading = ' ';
 	}
 
-	// if input == 0, format it to the totalDigits
-	if (input == 0) {
-		string s = "0";
-		for (int i = 0; i < totalDigits - 1; i++) {
-			s = leading + s;
-		}
+	s.appendNumber(input, totalDigits, leading);
+}
+
+void StudentWorld::initializeAllValues() {
+	m_nCitizens = 0;
+	m_levelFinishedIfAllCitizensGone = false;
+	m_levelWidth = LEVEL_WIDTH;
+	m_levelHeight = LEVEL_HEIGHT;
+	m_displayText.clear();
+	m_nextActorID = 1;		// Penelope is 0
+}
+
+bool StudentWorld::neverChanges(int kind) {
+	return kind == KIND_WALL || kind == KIND_EXIT || kind == KIND_PIT;
+}
+
+void StudentWorld::saveActor(const Actor* a, RewindState& state) const {
+	RewindObject o = {};
+	o.id = a->id();
+	o.kind = a->kind();
+	o.x = static_cast<int>(lround(a->getX()));		// actors only ever move whole pixels
+	o.y = static_cast<int>(lround(a->getY()));
+	o.direction = a->getDirection();
+	a->saveState(o.values);
+	state.objects.push_back(o);
+}
 
-		return s;
+bool StudentWorld::saveWorldState(RewindState& state) const {
+	if (m_penelope == nullptr) {	// no level loaded
+		return false;
 	}
 
-	// convert integer to string
-	string s = to_string(input);
-	for (int i = s.length(); i < totalDigits; i++) {
-		s = leading + s;
+	for (int k = 0; k < RewindState::NUM_WORLD_VALUES; k++) {
+		state.worldValues[k] = 0;
 	}
+	state.worldValues[0] = m_nCitizens;
+	state.worldValues[1] = m_levelFinishedIfAllCitizensGone;
+	state.worldValues[2] = m_nextActorID;
+
+	// Penelope first, since her ID is 0, then the others (already in ID order)
+	state.objects.clear();
+	saveActor(m_penelope, state);
+	for (size_t k = 0; k < m_actors.size(); k++) {
+		if (!neverChanges(m_actors[k]->kind())) {
+			saveActor(m_actors[k], state);
+		}
+	}
+	return true;
+}
 
-	return s;
+Actor* StudentWorld::createActor(const RewindObject& o) {
+	Actor* a;
+	switch (o.kind) {
+	case KIND_FLAME:			a = new Flame(this, o.x, o.y, o.direction);		break;
+	case KIND_VOMIT:			a = new Vomit(this, o.x, o.y, o.direction);		break;
+	case KIND_LANDMINE:			a = new Landmine(this, o.x, o.y);				break;
+	case KIND_VACCINE_GOODIE:	a = new VaccineGoodie(this, o.x, o.y);			break;
+	case KIND_GAS_CAN_GOODIE:	a = new GasCanGoodie(this, o.x, o.y);			break;
+	case KIND_LANDMINE_GOODIE:	a = new LandmineGoodie(this, o.x, o.y);			break;
+	case KIND_CITIZEN:			a = new Citizen(this, o.x, o.y);				break;
+	case KIND_DUMB_ZOMBIE:		a = new DumbZombie(this, o.x, o.y);				break;
+	case KIND_SMART_ZOMBIE:		a = new SmartZombie(this, o.x, o.y);			break;
+	default:					return nullptr;
+	}
+	a->setID(o.id);
+	a->setDirection(o.direction);
+	a->restoreState(o.values);
+	return a;
 }
 
-void StudentWorld::initializeAllValues() {
-	m_nCitizens = 0;
-	m_levelFinishedIfAllCitizensGone = false;
+bool StudentWorld::restoreWorldState(const RewindState& state) {
+	if (m_penelope == nullptr || state.objects.empty() || state.objects[0].kind != KIND_PENELOPE) {
+		return false;
+	}
+
+	const RewindObject& p = state.objects[0];
+	m_penelope->moveTo(p.x, p.y);
+	m_penelope->setDirection(p.direction);
+	m_penelope->restoreState(p.values);
+
+	// Keep the actors that never change and replace the rest, merging the
+	// two by ID so that they act in the same order as before
+	std::vector<Actor*> actors;
+	actors.reserve(m_actors.size() + state.objects.size());
+	size_t k = 0;
+	auto keepOrDelete = [&actors](Actor* a) {
+		if (neverChanges(a->kind())) {
+			actors.push_back(a);
+		}
+		else {
+			delete a;
+		}
+	};
+	for (size_t n = 1; n < state.objects.size(); n++) {
+		for ( ; k < m_actors.size() && m_actors[k]->id() < state.objects[n].id; k++) {
+			keepOrDelete(m_actors[k]);
+		}
+		Actor* a = createActor(state.objects[n]);
+		if (a != nullptr) {
+			actors.push_back(a);
+		}
+	}
+	for ( ; k < m_actors.size(); k++) {
+		keepOrDelete(m_actors[k]);
+	}
+	m_actors.swap(actors);
+
+	m_nCitizens = state.worldValues[0];
+	m_levelFinishedIfAllCitizensGone = (state.worldValues[1] != 0);
+	m_nextActorID = state.worldValues[2];
+	setDisplayText();
+	return true;
 }
\ No newline at end of file
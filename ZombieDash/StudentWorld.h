@@ -2,6 +2,7 @@
 #define STUDENTWORLD_INCLUDED
 
 #include "GameWorld.h"
+#include "FixedString.h"
 #include <string>
 #include <vector>
 
@@ -17,8 +18,12 @@ public:
     virtual int move();
     virtual void cleanUp();
 
+	virtual void getCameraFocus(double& x, double& y) const;	// follows Penelope
+	virtual void getWorldSize(double& width, double& height) const;
+
 	Penelope* player();
 	int nCitizens() const;
+	int nActors() const;		// number of actors other than Penelope
 	void decNCitizens();		// decrement citizens by 1
 	bool levelFinishedIfAllCitizensGone() const;
 
@@ -64,16 +69,29 @@ public:
 
 private:
 	// functions to help display stats
+	using DisplayText = FixedString<128>;	// fixed capacity, so formatting it every tick doesn't allocate
 	void setDisplayText();
-	std::string formatDisplayText(int score, int level, int lives, int vaccines, int flames, int mines, int infected) const;
-	std::string formatDigit(int input, int totalDigits, bool zeros) const;
+	void formatDisplayText(DisplayText& s, int score, int level, int lives, int vaccines, int flames, int mines, int infected) const;
+	void formatDigit(DisplayText& s, int input, int totalDigits, bool zeros) const;
 
 	void initializeAllValues();		// initializes data members
 
+	// saving and restoring the world for rewinding; walls, exits, and pits
+	// never change, so they are left as they are
+	virtual bool saveWorldState(RewindState& state) const;
+	virtual bool restoreWorldState(const RewindState& state);
+	static bool neverChanges(int kind);
+	void saveActor(const Actor* a, RewindState& state) const;
+	Actor* createActor(const RewindObject& o);
+
 	Penelope* m_penelope;
+	DisplayText m_displayText;		// the text last passed to setGameStatText
 	std::vector<Actor*> m_actors;
 	int m_nCitizens;
 	bool m_levelFinishedIfAllCitizensGone;
+	int m_levelWidth;		// in cells
+	int m_levelHeight;
+	unsigned int m_nextActorID;		// for the next actor added
 };
 
 #endif // STUDENTWORLD_INCLUDED
\ No newline at end of file
@@ -0,0 +1,236 @@
+#ifndef TGADECODER_H_
+#define TGADECODER_H_
+
+#include <vector>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__SSE2__)  ||  defined(_M_X64)  ||  (defined(_M_IX86_FP)  &&  _M_IX86_FP >= 2)
+#define TGA_DECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+  // Decodes a TGA file already in memory: uncompressed (types 2 and 3) or
+  // run-length encoded (types 10 and 11), 24- or 32-bit color or 8-bit
+  // greyscale, stored from either corner.  Pixels come out as BGRA with
+  // alpha premultiplied, bottom row first, which is how the sprite atlas
+  // holds them.  Decoding works a row at a time straight into the caller's
+  // buffer; an RLE row is expanded into a one-row scratch buffer first, so
+  // there is never a second copy of the whole image.
+class TgaDecoder
+{
+  public:
+    TgaDecoder()
+     : m_data(nullptr), m_size(0), m_width(0), m_height(0), m_bytesPerPixel(0),
+       m_pixelOffset(0), m_rle(false), m_topFirst(false), m_rightToLeft(false)
+    {}
+
+      // Check the header of the size bytes at data, which must stay valid
+      // until decoding is done
+    bool parse(const char* data, size_t size)
+    {
+        m_data = reinterpret_cast<const unsigned char*>(data);
+        m_size = size;
+        if (size < HEADER_SIZE)
+            return false;
+
+        const unsigned char* h = m_data;
+        unsigned int idLength = h[0];
+        unsigned int colorMapType = h[1];
+        unsigned int imageType = h[2];
+        unsigned int colorMapLength = h[5] | (h[6] << 8);
+        unsigned int colorMapEntryBits = h[7];
+        m_width = h[12] | (h[13] << 8);
+        m_height = h[14] | (h[15] << 8);
+        unsigned int bitsPerPixel = h[16];
+        unsigned int descriptor = h[17];
+
+        m_rle = (imageType == 10  ||  imageType == 11);
+        bool grey = (imageType == 3  ||  imageType == 11);
+        if (!grey  &&  imageType != 2  &&  imageType != 10)
+            return false;   // color-mapped or not an image
+        if (grey ? bitsPerPixel != 8 : (bitsPerPixel != 24  &&  bitsPerPixel != 32))
+            return false;
+        if (colorMapType > 1  ||  m_width == 0  ||  m_height == 0)
+            return false;
+
+        m_bytesPerPixel = bitsPerPixel / 8;
+        m_topFirst = (descriptor & 0x20) != 0;
+        m_rightToLeft = (descriptor & 0x10) != 0;
+          // A true-color image may still carry a color map, which is skipped
+        m_pixelOffset = HEADER_SIZE + idLength +
+                        (colorMapType == 1 ? colorMapLength * ((colorMapEntryBits + 7) / 8) : 0);
+        if (m_pixelOffset > size)
+            return false;
+        return m_rle  ||  size - m_pixelOffset >= static_cast<size_t>(m_width) * m_height * m_bytesPerPixel;
+    }
+
+    unsigned int width() const
+    {
+        return m_width;
+    }
+
+    unsigned int height() const
+    {
+        return m_height;
+    }
+
+      // Write the image as premultiplied BGRA, bottom row first, with each
+      // row destStride bytes after the one below it.  False if RLE data
+      // runs out early, in which case the rows not yet reached are left
+      // as they were.
+    bool decode(unsigned char* dest, size_t destStride)
+    {
+        size_t rowBytes = static_cast<size_t>(m_width) * m_bytesPerPixel;
+        if (m_rle)
+            m_row.resize(rowBytes);
+        RunState run = { m_pixelOffset, 0, false };
+        for (unsigned int r = 0; r < m_height; r++)
+        {
+            const unsigned char* source;
+            if (m_rle)
+            {
+                if (!expandRow(run, m_row.data()))
+                    return false;
+                source = m_row.data();
+            }
+            else
+                source = m_data + m_pixelOffset + r * rowBytes;
+
+            unsigned int destRow = (m_topFirst ? m_height - 1 - r : r);
+            convertRow(source, dest + destRow * destStride);
+        }
+        return true;
+    }
+
+  private:
+    static const size_t HEADER_SIZE = 18;
+
+      // Where RLE decoding is in the file; a packet may cross rows
+    struct RunState
+    {
+        size_t       offset;        // next byte to read
+        unsigned int remaining;     // pixels left in the current packet
+        bool         repeat;        // whether the packet repeats one pixel
+    };
+
+    const unsigned char* m_data;
+    size_t               m_size;
+    unsigned int         m_width;
+    unsigned int         m_height;
+    unsigned int         m_bytesPerPixel;
+    size_t               m_pixelOffset;
+    bool                 m_rle;
+    bool                 m_topFirst;
+    bool                 m_rightToLeft;
+    std::vector<unsigned char> m_row;   // one expanded RLE row
+
+    bool expandRow(RunState& run, unsigned char* row) const
+    {
+        unsigned int bpp = m_bytesPerPixel;
+        for (unsigned int x = 0; x < m_width; )
+        {
+            if (run.remaining == 0)
+            {
+                if (run.offset >= m_size)
+                    return false;
+                unsigned int packet = m_data[run.offset++];
+                run.repeat = (packet & 0x80) != 0;
+                run.remaining = (packet & 0x7f) + 1;
+            }
+
+            unsigned int n = (run.remaining < m_width - x ? run.remaining : m_width - x);
+            size_t needed = (run.repeat ? bpp : n * bpp);
+            if (m_size - run.offset < needed)
+                return false;
+            const unsigned char* src = m_data + run.offset;
+            if (run.repeat)
+            {
+                for (unsigned int k = 0; k < n; k++)
+                    std::memcpy(row + (x + k) * bpp, src, bpp);
+                  // The repeated pixel is consumed with the packet's last
+                if (run.remaining == n)
+                    run.offset += bpp;
+            }
+            else
+            {
+                std::memcpy(row + x * bpp, src, needed);
+                run.offset += needed;
+            }
+            run.remaining -= n;
+            x += n;
+        }
+        return true;
+    }
+
+      // x * a / 255, rounded, exactly; the SSE2 path computes the same
+    static unsigned char premultiply(unsigned int x, unsigned int a)
+    {
+        unsigned int t = x * a + 128;
+        return static_cast<unsigned char>((t + (t >> 8)) >> 8);
+    }
+
+    void convertRow(const unsigned char* source, unsigned char* dest) const
+    {
+        unsigned int width = m_width;
+        if (m_rightToLeft)
+        {
+              // Rare enough not to bother with anything but the simple way
+            for (unsigned int x = 0; x < width; x++)
+                convertPixel(source + (width - 1 - x) * m_bytesPerPixel, dest + x * 4);
+            return;
+        }
+
+        unsigned int x = 0;
+#ifdef TGA_DECODER_SSE2
+        if (m_bytesPerPixel == 4)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            const __m128i alphaScale = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+            const __m128i half = _mm_set1_epi16(128);
+            for ( ; x + 4 <= width; x += 4)
+            {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x * 4));
+                __m128i halves[2] = { _mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero) };
+                for (__m128i& v : halves)
+                {
+                      // Multiply B, G and R by A, and A by 255 so it stays A
+                    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xff), 0xff);
+                    alpha = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), alphaScale);
+                    __m128i t = _mm_add_epi16(_mm_mullo_epi16(v, alpha), half);
+                    v = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 4), _mm_packus_epi16(halves[0], halves[1]));
+            }
+        }
+#endif
+        for ( ; x < width; x++)
+            convertPixel(source + x * m_bytesPerPixel, dest + x * 4);
+    }
+
+    void convertPixel(const unsigned char* src, unsigned char* dest) const
+    {
+        switch (m_bytesPerPixel)
+        {
+            case 1:
+                dest[0] = dest[1] = dest[2] = src[0];
+                dest[3] = 255;
+                break;
+            case 3:
+                dest[0] = src[0];
+                dest[1] = src[1];
+                dest[2] = src[2];
+                dest[3] = 255;
+                break;
+            default:
+                dest[0] = premultiply(src[0], src[3]);
+                dest[1] = premultiply(src[1], src[3]);
+                dest[2] = premultiply(src[2], src[3]);
+                dest[3] = src[3];
+                break;
+        }
+    }
+};
+
+#endif // TGADECODER_H_
@@ -0,0 +1,64 @@
+#ifndef TRIPLEBUFFER_H_
+#define TRIPLEBUFFER_H_
+
+#include <atomic>
+
+  // Lock-free single-producer, single-consumer triple buffer.  The producer
+  // fills back() and calls publish(); the consumer calls acquire() and then
+  // reads front().  Neither side ever waits: the producer always has a
+  // buffer to write, and the consumer always sees the most recently
+  // published one (intermediate ones it didn't get to are skipped).
+
+template<typename T>
+class TripleBuffer
+{
+  public:
+    TripleBuffer()
+     : m_middle(1), m_back(0), m_front(2)
+    {}
+
+      // Producer side
+
+    T& back()
+    {
+        return m_buffers[m_back];
+    }
+
+    void publish()
+    {
+        int old = m_middle.exchange(m_back | NEW_DATA, std::memory_order_acq_rel);
+        m_back = old & INDEX_MASK;
+    }
+
+      // Consumer side
+
+      // Make the most recently published buffer the front one.  Returns
+      // false (and leaves front() alone) if nothing new was published.
+    bool acquire()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & NEW_DATA) == 0)
+            return false;
+        int old = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = old & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const
+    {
+        return m_buffers[m_front];
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  private:
+    static const int INDEX_MASK = 3;
+    static const int NEW_DATA = 4;
+
+    T                m_buffers[3];
+    std::atomic<int> m_middle;      // index of the middle buffer, plus NEW_DATA
+    int              m_back;        // touched only by the producer
+    int              m_front;       // touched only by the consumer
+};
+
+#endif // TRIPLEBUFFER_H_
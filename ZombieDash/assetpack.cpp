@@ -0,0 +1,163 @@
+#include "AssetPack.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+  // Asset packer: bundles the sprites, sounds, and levels in a directory
+  // into one pack file that the game maps into memory at startup.
+  //
+  //   assetpack [--compress] assetDirectory outputFile
+  //   assetpack --list packFile
+  //
+  // Options:
+  //   --compress          compress each file that gets smaller that way
+  //   --list              show what a pack holds
+  //
+  // Files ending in .tga, .wav, .txt, and .lvl are packed under their
+  // names without the directory; the game finds a pack named Assets.pak in
+  // its working directory and reads what it holds in place of Assets/.
+
+#ifdef _MSC_VER
+static bool listDirectory(string dir, vector<string>& names)
+{
+    WIN32_FIND_DATAA found;
+    HANDLE h = FindFirstFileA((dir + "/*").c_str(), &found);
+    if (h == INVALID_HANDLE_VALUE)
+        return false;
+    do
+    {
+        if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            names.push_back(found.cFileName);
+    } while (FindNextFileA(h, &found));
+    FindClose(h);
+    return true;
+}
+#else
+#include <dirent.h>
+static bool listDirectory(string dir, vector<string>& names)
+{
+    DIR* d = opendir(dir.c_str());
+    if (d == nullptr)
+        return false;
+    while (dirent* entry = readdir(d))
+    {
+        string name = entry->d_name;
+        struct stat statbuf;
+        if (stat((dir + "/" + name).c_str(), &statbuf) == 0  &&  S_ISREG(statbuf.st_mode))
+            names.push_back(name);
+    }
+    closedir(d);
+    return true;
+}
+#endif
+
+static void usage()
+{
+    cout << "usage: assetpack [--compress] assetDirectory outputFile" << endl
+         << "       assetpack --list packFile" << endl;
+}
+
+static bool isAsset(const string& name)
+{
+    const char* extensions[] = { ".tga", ".wav", ".txt", ".lvl" };
+    for (const char* ext : extensions)
+    {
+        size_t len = char_traits<char>::length(ext);
+        if (name.size() > len  &&  name.compare(name.size() - len, len, ext) == 0)
+            return true;
+    }
+    return false;
+}
+
+static int listPack(string packFile)
+{
+    AssetPack pack;
+    if (!pack.open(packFile))
+    {
+        cout << "Cannot open pack " << packFile << endl;
+        return 1;
+    }
+    for (const string& name : pack.names())
+    {
+        AssetData data;
+        if (!pack.read(name, data))
+        {
+            cout << name << ": damaged" << endl;
+            return 1;
+        }
+        cout << name << " " << data.size() << (data.ownsData() ? " (compressed)" : "") << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    bool compress = false;
+    string listFile;
+    vector<string> files;
+
+    for (int k = 1; k < argc; k++)
+    {
+        string arg = argv[k];
+        if (arg == "--compress")
+            compress = true;
+        else if (arg == "--list"  &&  k + 1 < argc)
+            listFile = argv[++k];
+        else if (!arg.empty()  &&  arg[0] != '-')
+            files.push_back(arg);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (!listFile.empty())
+        return listPack(listFile);
+    if (files.size() != 2)
+    {
+        usage();
+        return 1;
+    }
+
+    string assetDir = files[0];
+    string outputFile = files[1];
+    vector<string> names;
+    if (!listDirectory(assetDir, names))
+    {
+        cout << "Cannot find directory " << assetDir << endl;
+        return 1;
+    }
+
+    vector<AssetPack::Input> inputs;
+    size_t totalSize = 0;
+    for (const string& name : names)
+    {
+        if (!isAsset(name))
+            continue;
+        ifstream file(assetDir + "/" + name, ios::in|ios::binary);
+        if (!file)
+        {
+            cout << "Cannot read " << name << endl;
+            return 1;
+        }
+        AssetPack::Input in;
+        in.name = name;
+        in.contents.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        totalSize += in.contents.size();
+        inputs.push_back(move(in));
+    }
+
+    size_t count = inputs.size();
+    if (!AssetPack::write(outputFile, move(inputs), compress))
+    {
+        cout << "Cannot write " << outputFile << endl;
+        return 1;
+    }
+    ifstream packed(outputFile, ios::in|ios::binary|ios::ate);
+    cout << "Packed " << count << " files (" << totalSize << " bytes) into "
+         << outputFile << " (" << packed.tellg() << " bytes)" << endl;
+    return 0;
+}
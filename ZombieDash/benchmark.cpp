@@ -0,0 +1,681 @@
+#include "StudentWorld.h"
+#include "Actor.h"
+#include "Level.h"
+#include "LevelGenerator.h"
+#include "AllocationCounter.h"
+#include "RenderQueue.h"
+#include "GameController.h"
+#include "RewindBuffer.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+
+#ifdef _MSC_VER
+#include <direct.h>
+static void makeDirectory(string path)
+{
+    _mkdir(path.c_str());
+}
+#else
+#include <sys/stat.h>
+static void makeDirectory(string path)
+{
+    mkdir(path.c_str(), 0755);
+}
+#endif
+
+  // Benchmarks for the simulation hot paths.
+  //
+  //   benchmark [--assets dir] [--work-dir dir] [--filter text] [--quick]
+  //             [--json file] [--compare baseline.json] [--threshold percent]
+  //
+  // Every benchmark reports the median and 99th percentile time of one
+  // iteration (one query, or one StudentWorld::move tick) and the number of
+  // heap allocations per iteration; render queue benchmarks also report the
+  // texture binds per frame.  --json writes the results; --compare
+  // reads an earlier --json file and exits with status 1 if any benchmark's
+  // median got slower by more than the threshold (default 10%).  The run
+  // also exits with status 1 if a world that creates no actors (the calm
+  // scenario) makes any heap allocation in a tick once warmed up, whether
+  // or not the tick is also recorded for rewind.
+
+using Clock = chrono::steady_clock;
+
+struct BenchResult
+{
+    string    name;
+    int       actors;
+    long long iterations;
+    double    medianNs;
+    double    p99Ns;
+    double    allocsPerIteration;
+    double    bindsPerIteration;    // negative if not measured
+};
+
+struct BenchOptions
+{
+    string assetDir;
+    string workDir;
+    string filter;
+    string jsonFile;
+    string baselineFile;
+    double thresholdPercent;
+    bool   quick;
+};
+
+static BenchOptions g_options;
+static vector<BenchResult> g_results;
+static vector<string> g_allocationFailures;   // benchmarks that allocated but must not
+
+static double percentile(vector<double> samples, double p)
+{
+    if (samples.empty())
+        return 0;
+    sort(samples.begin(), samples.end());
+    size_t k = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+    return samples[k];
+}
+
+static bool selected(string name)
+{
+    return g_options.filter.empty()  ||  name.find(g_options.filter) != string::npos;
+}
+
+static void report(string name, int actors, const vector<double>& samplesNs,
+                   long long iterations, long long allocations, double binds = -1)
+{
+    BenchResult r;
+    r.name = name;
+    r.actors = actors;
+    r.iterations = iterations;
+    r.medianNs = percentile(samplesNs, .5);
+    r.p99Ns = percentile(samplesNs, .99);
+    r.allocsPerIteration = (iterations == 0 ? 0 : double(allocations) / iterations);
+    r.bindsPerIteration = binds;
+    g_results.push_back(r);
+
+    cout << left << setw(52) << name << right
+         << setw(8) << actors << " actors"
+         << setw(14) << fixed << setprecision(1) << r.medianNs << " ns"
+         << setw(14) << r.p99Ns << " ns p99"
+         << setw(10) << setprecision(2) << r.allocsPerIteration << " allocs";
+    if (binds >= 0)
+        cout << setw(10) << setprecision(1) << binds << " binds";
+    cout << endl;
+}
+
+  // StudentWorld logs every actor it creates; keep that out of the timings
+  // and the report.
+class QuietCerr
+{
+  public:
+    QuietCerr()
+     : m_saved(cerr.rdbuf(nullptr))
+    {}
+
+    ~QuietCerr()
+    {
+        cerr.rdbuf(m_saved);
+    }
+
+  private:
+    streambuf* m_saved;
+};
+
+  // A world loaded from assetDir's levelNN.txt, with its size in cells
+struct BenchWorld
+{
+    StudentWorld* world;
+    int           width;
+    int           height;
+    string        assetDir;
+    int           levelNumber;
+};
+
+static bool loadWorld(string assetDir, int levelNumber, BenchWorld& bw)
+{
+    ostringstream levelFile;
+    levelFile << "level" << setw(2) << setfill('0') << levelNumber << ".txt";
+    Level lev(assetDir);
+    if (lev.loadLevel(levelFile.str()) != Level::load_success)
+        return false;
+
+    bw.world = new StudentWorld(assetDir);
+    bw.world->setController(&Game());   // so HUD text goes the whole way, as in the game
+    for (int k = 1; k < levelNumber; k++)
+        bw.world->advanceToNextLevel();
+    bw.width = lev.getWidth();
+    bw.height = lev.getHeight();
+    bw.assetDir = assetDir;
+    bw.levelNumber = levelNumber;
+
+    QuietCerr quiet;
+    if (bw.world->init() != GWSTATUS_CONTINUE_GAME)
+    {
+        delete bw.world;
+        return false;
+    }
+    return true;
+}
+
+static void restartWorld(BenchWorld& bw)
+{
+    QuietCerr quiet;
+    bw.world->cleanUp();
+    bw.world->init();
+}
+
+  // Generated levels each get their own directory so they can be loaded
+  // as level01.txt just like a shipped level.
+static string writeGeneratedLevel(string tag, const LevelGenParams& params)
+{
+    makeDirectory(g_options.workDir);
+    string dir = g_options.workDir + "/" + tag;
+    makeDirectory(dir);
+    Level lev("");
+    if (!LevelGenerator::generate(params, lev)  ||  !lev.saveLevel(dir + "/level01.txt", Level::text_format))
+    {
+        cout << "Cannot write generated level " << dir << endl;
+        exit(1);
+    }
+    return dir + "/";
+}
+
+struct QueryPoint
+{
+    double x;
+    double y;
+};
+
+static vector<QueryPoint> randomPoints(const BenchWorld& bw, int n)
+{
+    vector<QueryPoint> points(n);
+    for (QueryPoint& p : points)
+    {
+        p.x = randInt(0, bw.width * SPRITE_WIDTH - 1);
+        p.y = randInt(0, bw.height * SPRITE_HEIGHT - 1);
+    }
+    return points;
+}
+
+  // Time batches of calls to query, cycling through the query points
+template<typename Query>
+static void benchQuery(string name, BenchWorld& bw, Query query)
+{
+    if (!selected(name))
+        return;
+
+    const int samples = (g_options.quick ? 11 : 51);
+    const int batch = (g_options.quick ? 200 : 1000);
+    vector<QueryPoint> points = randomPoints(bw, 1024);
+    vector<double> samplesNs;
+    samplesNs.reserve(samples);     // so timing doesn't count our own allocations
+    int sink = 0;
+
+    for (int k = 0; k < batch; k++)     // warm up
+        sink += query(points[k % points.size()]);
+
+    long long allocsBefore = AllocationCounter::allocations();
+    for (int s = 0; s < samples; s++)
+    {
+        Clock::time_point start = Clock::now();
+        for (int k = 0; k < batch; k++)
+            sink += query(points[(s * batch + k) % points.size()]);
+        chrono::duration<double, nano> elapsed = Clock::now() - start;
+        samplesNs.push_back(elapsed.count() / batch);
+    }
+    long long allocs = AllocationCounter::allocations() - allocsBefore;
+
+    volatile int keep = sink;
+    (void)keep;
+    report(name, bw.world->nActors(), samplesNs, static_cast<long long>(samples) * batch, allocs);
+}
+
+static void benchQueries(string prefix, BenchWorld& bw)
+{
+    StudentWorld* w = bw.world;
+
+    benchQuery(prefix + "/isAgentMovementBlockedAt", bw,
+        [w](const QueryPoint& p) { return w->isAgentMovementBlockedAt(p.x, p.y) ? 1 : 0; });
+    benchQuery(prefix + "/isFlameBlockedAt", bw,
+        [w](const QueryPoint& p) { return w->isFlameBlockedAt(p.x, p.y) ? 1 : 0; });
+    benchQuery(prefix + "/isZombieVomitTriggerAt", bw,
+        [w](const QueryPoint& p) { return w->isZombieVomitTriggerAt(p.x, p.y) ? 1 : 0; });
+
+      // A wall never reacts to being activated, so the probe measures only
+      // the overlap scan.
+    Wall probe(w, 0, 0);
+    benchQuery(prefix + "/activateOnAppropriateActors", bw,
+        [w, &probe](const QueryPoint& p) { probe.moveTo(p.x, p.y); w->activateOnAppropriateActors(&probe); return 0; });
+}
+
+  // Time whole ticks.  If the level ends (Penelope dies or exits), reload it
+  // untimed and keep going.
+  // If allocationFree, the world creates nothing while it runs, so once
+  // warmed up its ticks must make no heap allocations at all; if they do,
+  // the benchmark run fails.
+static void benchTicks(string name, BenchWorld& bw, int extraFlamesPerTick = 0, bool allocationFree = false)
+{
+    if (!selected(name))
+        return;
+
+    const int warmupTicks = 5;
+    const int maxTicks = (g_options.quick ? 50 : 500);
+    const double budgetSeconds = (g_options.quick ? 0.25 : 2.0);
+    vector<double> samplesNs;
+    samplesNs.reserve(maxTicks);
+    long long allocs = 0;
+    int actors = bw.world->nActors();
+    Clock::time_point benchStart = Clock::now();
+
+    for (int tick = 0; tick < warmupTicks + maxTicks; tick++)
+    {
+        long long allocsBefore = AllocationCounter::allocations();
+        Clock::time_point start = Clock::now();
+
+          // Flames in the bottom-left corner overlap only the border walls,
+          // so they exercise spawning and removal without changing the game.
+        for (int k = 0; k < extraFlamesPerTick; k++)
+            bw.world->addActor(new Flame(bw.world, 0, 0, GraphObject::right));
+        int status = bw.world->move();
+
+        chrono::duration<double, nano> elapsed = Clock::now() - start;
+        if (tick >= warmupTicks)
+        {
+            samplesNs.push_back(elapsed.count());
+            allocs += AllocationCounter::allocations() - allocsBefore;
+        }
+
+        if (status != GWSTATUS_CONTINUE_GAME)
+            restartWorld(bw);
+
+        chrono::duration<double> total = Clock::now() - benchStart;
+        if (tick >= warmupTicks + 10  &&  total.count() > budgetSeconds)
+            break;
+    }
+
+    report(name, actors, samplesNs, samplesNs.size(), allocs);
+    if (allocationFree  &&  allocs != 0)
+        g_allocationFailures.push_back(name);
+}
+
+  // Time whole ticks the way the game runs them, each followed by saving
+  // the world's state into a rewind buffer.  The buffer is kept small, and
+  // the warm-up lasts until it has forgotten every tick it held when it
+  // first filled, so the timed ticks reuse the storage of forgotten ones.
+  // If allocationFree, they must make no heap allocations at all.
+static void benchRewindTicks(string name, BenchWorld& bw, bool allocationFree = false)
+{
+    if (!selected(name))
+        return;
+
+    const size_t rewindBudget = 4 << 10;
+    const int maxWarmupTicks = 20000;
+    const int maxTicks = (g_options.quick ? 50 : 500);
+    const double budgetSeconds = (g_options.quick ? 0.25 : 2.0);
+    RewindBuffer rewind(rewindBudget);
+    RewindState state;
+    vector<double> samplesNs;
+    samplesNs.reserve(maxTicks);
+    long long allocs = 0;
+    int actors = bw.world->nActors();
+    long long wrapTick = -1;    // the last tick held when the buffer first filled
+    int warmupTicks = -1;
+    Clock::time_point benchStart = Clock::now();
+
+    for (int tick = 0; warmupTicks < 0  ||  tick < warmupTicks + maxTicks; tick++)
+    {
+        long long allocsBefore = AllocationCounter::allocations();
+        Clock::time_point start = Clock::now();
+
+        int status = bw.world->move();
+        if (bw.world->saveState(state))
+        {
+            state.tick = tick;
+            rewind.record(state);
+        }
+
+        chrono::duration<double, nano> elapsed = Clock::now() - start;
+        if (warmupTicks >= 0)
+        {
+            samplesNs.push_back(elapsed.count());
+            allocs += AllocationCounter::allocations() - allocsBefore;
+        }
+        else
+        {
+            if (wrapTick < 0  &&  rewind.firstTick() > 0)
+                wrapTick = rewind.lastTick();
+            if ((wrapTick >= 0  &&  rewind.firstTick() > wrapTick)  ||  tick + 1 == maxWarmupTicks)
+            {
+                warmupTicks = tick + 1;
+                benchStart = Clock::now();
+            }
+        }
+
+        if (status != GWSTATUS_CONTINUE_GAME)
+            restartWorld(bw);
+
+        chrono::duration<double> total = Clock::now() - benchStart;
+        if (warmupTicks >= 0  &&  tick >= warmupTicks + 10  &&  total.count() > budgetSeconds)
+            break;
+    }
+
+    report(name, actors, samplesNs, samplesNs.size(), allocs);
+    if (allocationFree  &&  allocs != 0)
+        g_allocationFailures.push_back(name);
+}
+
+  // Time gathering what a view centered on Penelope shows, the way the
+  // game builds each frame's snapshot.  This should depend on how crowded
+  // the view is, not on the size of the world.
+static void benchVisibleSet(string name, BenchWorld& bw)
+{
+    if (!selected(name))
+        return;
+
+    const int samples = (g_options.quick ? 11 : 51);
+    const int batch = (g_options.quick ? 20 : 100);
+    vector<double> samplesNs;
+    samplesNs.reserve(samples);
+    long long sink = 0;
+    auto count = [&sink](int imageID, int, double, double, double, double, int, double, int, long long) { sink += imageID; };
+
+    double focusX, focusY, worldWidth, worldHeight;
+    bw.world->getCameraFocus(focusX, focusY);
+    bw.world->getWorldSize(worldWidth, worldHeight);
+    double minX = max(0.0, min(focusX - VIEW_WIDTH / 2, worldWidth - VIEW_WIDTH));
+    double minY = max(0.0, min(focusY - VIEW_HEIGHT / 2, worldHeight - VIEW_HEIGHT));
+    double maxX = minX + VIEW_WIDTH;
+    double maxY = minY + VIEW_HEIGHT;
+
+    for (int k = 0; k < batch; k++)     // warm up
+    {
+        bw.world->scene().drawDynamicObjects(minX, minY, maxX, maxY, count);
+        bw.world->scene().drawStaticObjects(minX, minY, maxX, maxY, count);
+    }
+
+    long long allocsBefore = AllocationCounter::allocations();
+    for (int s = 0; s < samples; s++)
+    {
+        Clock::time_point start = Clock::now();
+        for (int k = 0; k < batch; k++)
+        {
+            bw.world->scene().drawDynamicObjects(minX, minY, maxX, maxY, count);
+            bw.world->scene().drawStaticObjects(minX, minY, maxX, maxY, count);
+        }
+        chrono::duration<double, nano> elapsed = Clock::now() - start;
+        samplesNs.push_back(elapsed.count() / batch);
+    }
+    long long allocs = AllocationCounter::allocations() - allocsBefore;
+
+    volatile long long keep = sink;
+    (void)keep;
+    report(name, bw.world->nActors(), samplesNs, static_cast<long long>(samples) * batch, allocs);
+}
+
+  // Time building and sorting a render queue for the view centered on
+  // Penelope, and count the texture binds drawing it would take.  The game
+  // packs every sprite into one atlas page, so to show how well the queue
+  // groups state, binds are counted as if each image had a texture of its
+  // own (as before the atlas).  With sorted false, the queue is drawn in
+  // the order the scene hands objects over instead, for comparison.
+static void benchRenderQueue(string name, BenchWorld& bw, bool sorted)
+{
+    if (!selected(name))
+        return;
+
+    const int samples = (g_options.quick ? 11 : 51);
+    const int batch = (g_options.quick ? 20 : 100);
+    vector<double> samplesNs;
+    samplesNs.reserve(samples);
+    RenderQueue queue;
+    uint32_t nQueued = 0;
+    auto push = [&queue, &nQueued](int imageID, int, double, double, double, double, int, double, int depth, long long)
+    {
+        queue.push(depth, imageID, imageID, nQueued++);
+    };
+
+    double focusX, focusY, worldWidth, worldHeight;
+    bw.world->getCameraFocus(focusX, focusY);
+    bw.world->getWorldSize(worldWidth, worldHeight);
+    double minX = max(0.0, min(focusX - VIEW_WIDTH / 2, worldWidth - VIEW_WIDTH));
+    double minY = max(0.0, min(focusY - VIEW_HEIGHT / 2, worldHeight - VIEW_HEIGHT));
+    double maxX = minX + VIEW_WIDTH;
+    double maxY = minY + VIEW_HEIGHT;
+
+    int binds = 0;
+    auto buildQueue = [&]()
+    {
+        queue.clear();
+        nQueued = 0;
+        bw.world->scene().drawStaticObjects(minX, minY, maxX, maxY, push);
+        bw.world->scene().drawDynamicObjects(minX, minY, maxX, maxY, push);
+        if (sorted)
+            queue.sort();
+        binds = queue.forEachRun([](int, size_t, size_t) {});
+    };
+
+    for (int k = 0; k < batch; k++)     // warm up
+        buildQueue();
+
+    long long allocsBefore = AllocationCounter::allocations();
+    for (int s = 0; s < samples; s++)
+    {
+        Clock::time_point start = Clock::now();
+        for (int k = 0; k < batch; k++)
+            buildQueue();
+        chrono::duration<double, nano> elapsed = Clock::now() - start;
+        samplesNs.push_back(elapsed.count() / batch);
+    }
+    long long allocs = AllocationCounter::allocations() - allocsBefore;
+
+    report(name, bw.world->nActors(), samplesNs, static_cast<long long>(samples) * batch, allocs, binds);
+}
+
+static void runWorldBenchmarks(string prefix, BenchWorld& bw, bool allocationFree = false)
+{
+    benchQueries(prefix, bw);
+    benchVisibleSet(prefix + "/visibleSet", bw);
+    benchRenderQueue(prefix + "/renderQueue", bw, true);
+    benchRenderQueue(prefix + "/renderQueueUnsorted", bw, false);
+    benchTicks(prefix + "/move", bw, 0, allocationFree);
+    restartWorld(bw);
+    benchRewindTicks(prefix + "/moveWithRewind", bw, allocationFree);
+    restartWorld(bw);
+    benchTicks(prefix + "/churn64", bw, 64);
+}
+
+static void writeJson(string filename)
+{
+    ofstream out(filename);
+    if (!out)
+    {
+        cout << "Cannot write " << filename << endl;
+        exit(1);
+    }
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t k = 0; k < g_results.size(); k++)
+    {
+        const BenchResult& r = g_results[k];
+        out << "    { \"name\": \"" << r.name << "\""
+            << ", \"actors\": " << r.actors
+            << ", \"iterations\": " << r.iterations
+            << fixed << setprecision(1)
+            << ", \"median_ns\": " << r.medianNs
+            << ", \"p99_ns\": " << r.p99Ns
+            << setprecision(3)
+            << ", \"allocs_per_iteration\": " << r.allocsPerIteration;
+        if (r.bindsPerIteration >= 0)
+            out << setprecision(1) << ", \"binds_per_iteration\": " << r.bindsPerIteration;
+        out << " }" << (k + 1 < g_results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+  // Just enough JSON reading to get the name and median of each benchmark
+  // in a file written by writeJson.
+static bool readBaseline(string filename, vector<pair<string, double>>& baseline)
+{
+    ifstream in(filename);
+    if (!in)
+        return false;
+    string line;
+    while (getline(in, line))
+    {
+        size_t namePos = line.find("\"name\": \"");
+        size_t medianPos = line.find("\"median_ns\": ");
+        if (namePos == string::npos  ||  medianPos == string::npos)
+            continue;
+        namePos += 9;
+        size_t nameEnd = line.find('"', namePos);
+        baseline.push_back(make_pair(line.substr(namePos, nameEnd - namePos),
+                                     atof(line.c_str() + medianPos + 13)));
+    }
+    return true;
+}
+
+static int compareWithBaseline(string filename, double thresholdPercent)
+{
+    vector<pair<string, double>> baseline;
+    if (!readBaseline(filename, baseline))
+    {
+        cout << "Cannot read baseline " << filename << endl;
+        return 1;
+    }
+
+    int regressions = 0;
+    cout << endl << "Comparison with " << filename << " (threshold "
+         << thresholdPercent << "%)" << endl;
+    for (const BenchResult& r : g_results)
+    {
+        auto it = find_if(baseline.begin(), baseline.end(),
+                    [&r](const pair<string, double>& b) { return b.first == r.name; });
+        if (it == baseline.end()  ||  it->second <= 0)
+            continue;
+        double changePercent = (r.medianNs - it->second) / it->second * 100;
+        bool regressed = changePercent > thresholdPercent;
+        if (regressed)
+            regressions++;
+        cout << left << setw(52) << r.name << right
+             << setw(14) << fixed << setprecision(1) << it->second << " ->"
+             << setw(12) << r.medianNs << " ns"
+             << setw(9) << showpos << changePercent << noshowpos << "%"
+             << (regressed ? "  REGRESSION" : "") << endl;
+    }
+    cout << regressions << " regression(s)" << endl;
+    return regressions == 0 ? 0 : 1;
+}
+
+static void usage()
+{
+    cout << "usage: benchmark [--assets dir] [--work-dir dir] [--filter text] [--quick]" << endl
+         << "                 [--json file] [--compare baseline.json] [--threshold percent]" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    g_options.assetDir = "Assets/";
+    g_options.workDir = "bench_levels";
+    g_options.thresholdPercent = 10;
+    g_options.quick = false;
+
+    for (int k = 1; k < argc; k++)
+    {
+        string arg = argv[k];
+        bool hasValue = (k + 1 < argc);
+        if (arg == "--quick")
+            g_options.quick = true;
+        else if (arg == "--assets"  &&  hasValue)
+            g_options.assetDir = string(argv[++k]) + "/";
+        else if (arg == "--work-dir"  &&  hasValue)
+            g_options.workDir = argv[++k];
+        else if (arg == "--filter"  &&  hasValue)
+            g_options.filter = argv[++k];
+        else if (arg == "--json"  &&  hasValue)
+            g_options.jsonFile = argv[++k];
+        else if (arg == "--compare"  &&  hasValue)
+            g_options.baselineFile = argv[++k];
+        else if (arg == "--threshold"  &&  hasValue)
+            g_options.thresholdPercent = atof(argv[++k]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+      // The shipped levels
+    for (int level = 1; level <= 99; level++)
+    {
+        BenchWorld bw;
+        if (!loadWorld(g_options.assetDir, level, bw))
+            break;
+        ostringstream prefix;
+        prefix << "level" << setw(2) << setfill('0') << level;
+        runWorldBenchmarks(prefix.str(), bw);
+        delete bw.world;
+    }
+
+      // The standard generated scenarios
+    for (const LevelGenerator::Scenario& s : LevelGenerator::standardScenarios())
+    {
+        if (g_options.quick  &&  string(s.name) == "huge")
+            continue;
+        BenchWorld bw;
+        if (!loadWorld(writeGeneratedLevel(s.name, s.params), 1, bw))
+            continue;
+          // With no citizens or zombies, nothing is ever created
+        bool createsNothing = s.params.citizenDensity == 0  &&  s.params.dumbZombieDensity == 0  &&
+                              s.params.smartZombieDensity == 0;
+        runWorldBenchmarks(string("scenario/") + s.name, bw, createsNothing);
+        delete bw.world;
+    }
+
+      // Scaling sweep: same densities, growing maze, so actor count grows
+      // with the area
+    LevelGenParams sweepParams;
+    LevelGenerator::findScenario("medium", sweepParams);
+    const int sweepSizes[] = { 16, 32, 64, 128, 256 };
+    for (int size : sweepSizes)
+    {
+        if (g_options.quick  &&  size > 64)
+            break;
+        ostringstream tag;
+        tag << "sweep" << size;
+        sweepParams.width = sweepParams.height = size;
+        BenchWorld bw;
+        if (!loadWorld(writeGeneratedLevel(tag.str(), sweepParams), 1, bw))
+            continue;
+        ostringstream prefix;
+        prefix << "sweep/" << size << "x" << size;
+        benchQueries(prefix.str(), bw);
+        benchVisibleSet(prefix.str() + "/visibleSet", bw);
+        benchRenderQueue(prefix.str() + "/renderQueue", bw, true);
+        benchTicks(prefix.str() + "/move", bw);
+        delete bw.world;
+    }
+
+    if (!g_options.jsonFile.empty())
+        writeJson(g_options.jsonFile);
+
+    int status = 0;
+    if (!g_allocationFailures.empty())
+    {
+        cout << endl;
+        for (const string& name : g_allocationFailures)
+            cout << name << ": ALLOCATED DURING STEADY-STATE TICKS" << endl;
+        status = 1;
+    }
+
+    if (!g_options.baselineFile.empty()  &&  compareWithBaseline(g_options.baselineFile, g_options.thresholdPercent) != 0)
+        status = 1;
+
+    return status;
+}
@@ -0,0 +1,124 @@
+#include "LevelGenerator.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+using namespace std;
+
+  // Procedural level generator for stress testing and benchmarking.
+  //
+  //   levelgen [options] outputFile
+  //   levelgen [--binary] --standard-set directory
+  //
+  // Options:
+  //   --scenario name     start from a standard scenario (small, medium, huge, horde, calm)
+  //   --width n           maze width in cells
+  //   --height n          maze height in cells
+  //   --seed n            random seed (same seed, same maze)
+  //   --walls f           wall density (0 to 1)
+  //   --pits f            pit density
+  //   --citizens f        citizen density
+  //   --dumb f            dumb zombie density
+  //   --smart f           smart zombie density
+  //   --goodies f         goodie density
+  //   --binary            write the compiled binary format instead of text
+
+static void usage()
+{
+    cout << "usage: levelgen [--scenario name] [--width n] [--height n] [--seed n]" << endl
+         << "                [--walls f] [--pits f] [--citizens f] [--dumb f] [--smart f]" << endl
+         << "                [--goodies f] [--binary] outputFile" << endl
+         << "       levelgen [--binary] --standard-set directory" << endl
+         << "scenarios:";
+    for (const LevelGenerator::Scenario& s : LevelGenerator::standardScenarios())
+        cout << " " << s.name;
+    cout << endl;
+}
+
+static bool writeLevel(const LevelGenParams& params, string filename, Level::SaveFormat format)
+{
+    Level lev("");
+    if (!LevelGenerator::generate(params, lev))
+    {
+        cout << "Invalid generator parameters" << endl;
+        return false;
+    }
+    if (!lev.saveLevel(filename, format))
+    {
+        cout << "Cannot write " << filename << endl;
+        return false;
+    }
+    cout << "Wrote " << lev.getWidth() << "x" << lev.getHeight() << " level to " << filename << endl;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    LevelGenParams params;
+    LevelGenerator::findScenario("small", params);
+    Level::SaveFormat format = Level::text_format;
+    string outputFile;
+    string standardSetDir;
+
+    for (int k = 1; k < argc; k++)
+    {
+        string arg = argv[k];
+        bool hasValue = (k + 1 < argc);
+
+        if (arg == "--binary")
+            format = Level::binary_format;
+        else if (arg == "--scenario"  &&  hasValue)
+        {
+            if (!LevelGenerator::findScenario(argv[++k], params))
+            {
+                cout << "Unknown scenario " << argv[k] << endl;
+                usage();
+                return 1;
+            }
+        }
+        else if (arg == "--standard-set"  &&  hasValue)
+            standardSetDir = argv[++k];
+        else if (arg == "--width"  &&  hasValue)
+            params.width = atoi(argv[++k]);
+        else if (arg == "--height"  &&  hasValue)
+            params.height = atoi(argv[++k]);
+        else if (arg == "--seed"  &&  hasValue)
+            params.seed = static_cast<unsigned>(strtoul(argv[++k], nullptr, 10));
+        else if (arg == "--walls"  &&  hasValue)
+            params.wallDensity = atof(argv[++k]);
+        else if (arg == "--pits"  &&  hasValue)
+            params.pitDensity = atof(argv[++k]);
+        else if (arg == "--citizens"  &&  hasValue)
+            params.citizenDensity = atof(argv[++k]);
+        else if (arg == "--dumb"  &&  hasValue)
+            params.dumbZombieDensity = atof(argv[++k]);
+        else if (arg == "--smart"  &&  hasValue)
+            params.smartZombieDensity = atof(argv[++k]);
+        else if (arg == "--goodies"  &&  hasValue)
+            params.goodieDensity = atof(argv[++k]);
+        else if (!arg.empty()  &&  arg[0] != '-'  &&  outputFile.empty())
+            outputFile = arg;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (!standardSetDir.empty())
+    {
+        string extension = (format == Level::binary_format ? ".lvl" : ".txt");
+        for (const LevelGenerator::Scenario& s : LevelGenerator::standardScenarios())
+        {
+            if (!writeLevel(s.params, standardSetDir + "/" + s.name + extension, format))
+                return 1;
+        }
+        return 0;
+    }
+
+    if (outputFile.empty())
+    {
+        usage();
+        return 1;
+    }
+    return writeLevel(params, outputFile, format) ? 0 : 1;
+}
@@ -1,4 +1,5 @@
 #include "GameController.h"
+#include "AssetPack.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -26,6 +27,11 @@ bool is_directory(string path)
 
 const string assetDirectory = "Assets"; 
 
+  // If this pack file exists (assetpack builds it from the Assets
+  // directory), the assets are read from it instead of the directory.
+
+const string assetPackFile = "Assets.pak";
+
 class GameWorld;
 
 GameWorld* createStudentWorld(string assetPath = "");
@@ -34,18 +40,16 @@ int main(int argc, char* argv[])
 {
     string assetPath = assetDirectory;
     if (!assetPath.empty())
-    {
-        if (!is_directory(assetPath))
-        {
-            cout << "Cannot find directory " << assetPath << endl;
-            return 1;
-        }
         assetPath += '/';
+    if (!Assets().mount(assetPackFile, assetPath)  &&  !assetDirectory.empty()  &&
+        !is_directory(assetDirectory))
+    {
+        cout << "Cannot find directory " << assetDirectory << endl;
+        return 1;
     }
     {
         const string someAsset = "level01.txt";
-        ifstream ifs(assetPath + someAsset);
-        if (!ifs)
+        if (!Assets().exists(assetPath + someAsset))
         {
             cout << "Cannot find " << someAsset << " in ";
             cout << (assetDirectory.empty() ? "current directory" : assetDirectory) << endl;